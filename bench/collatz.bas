@@ -0,0 +1,25 @@
+10 rem longest collatz chain below 20000
+20 function steps(n)
+30  dim c
+40  c = 0
+50  do while n <> 1
+60   if n mod 2 = 0 then
+70    n = n / 2
+80   else
+90    n = 3 * n + 1
+100   end if
+110   c = c + 1
+120  loop
+130  return c
+140 end function
+150 best = 0
+160 for i = 1 to 20000
+170  s = steps(i)
+180  if s > best then
+190   best = s
+200   arg = i
+210  end if
+220 next i
+230 print arg, best
+240 print arg > 0 and best > 0, arg < 0 or best < 0
+250 print (arg > 0 and best > 0) = 1, 1 + (arg < 0 or best > 0)
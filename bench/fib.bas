@@ -0,0 +1,7 @@
+10 function fib(n)
+20  if n < 2 then
+30   return n
+40  end if
+50  return fib(n - 1) + fib(n - 2)
+60 end function
+70 print fib(30)
@@ -0,0 +1,11 @@
+10 rem count.bas scaled up, without the output
+20 t = 0
+30 for i = 1 to 20000
+40  for n = 0 to 100
+50   if n mod 10 = 0 then
+60    t = t + 1
+70   end if
+80   t = t + n
+90  next n
+100 next i
+110 print t
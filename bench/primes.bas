@@ -0,0 +1,17 @@
+10 rem count primes below 30000 by trial division
+20 function isprime(n)
+30  dim d
+40  d = 3
+50  do while d * d <= n
+60   if n mod d = 0 then return 0
+70   d = d + 2
+80  loop
+90  return 1
+100 end function
+110 count = 1
+120 n = 3
+130 do while n < 30000
+140  count = count + isprime(n)
+150  n = n + 2
+160 loop
+170 print count
@@ -0,0 +1,17 @@
+10 rem sieve of eratosthenes repeated over a fixed size array
+20 dim flags[2000]
+30 for pass = 1 to 2000
+40  for i = 0 to 1999
+50   flags[i] = 1
+60  next i
+70  count = 0
+80  for i = 2 to 1999
+90   if flags[i] then
+100   count = count + 1
+110   for k = i + i to 1999 step i
+120    flags[k] = 0
+130   next k
+140  end if
+150  next i
+160 next pass
+170 print count
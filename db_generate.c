@@ -1,289 +1,1008 @@
-/* db_generate.c - code generation functions
- *
- * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
- *
- */
-
-#include "db_compiler.h"
-
-/* local function prototypes */
-static void code_expr(ParseContext *c, ParseTreeNode *expr, PVAL *pv);
-static void code_shortcircuit(ParseContext *c, int op, ParseTreeNode *expr, PVAL *pv);
-static void code_arrayref(ParseContext *c, ParseTreeNode *expr, PVAL *pv);
-static void code_call(ParseContext *c, ParseTreeNode *expr, PVAL *pv);
-static void code_index(ParseContext *c, PValOp fcn, PVAL *pv);
-
-/* code_lvalue - generate code for an l-value expression */
-void code_lvalue(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
-{
-    code_expr(c, expr, pv);
-    chklvalue(c, pv);
-}
-
-/* code_rvalue - generate code for an r-value expression */
-void code_rvalue(ParseContext *c, ParseTreeNode *expr)
-{
-    PVAL pv;
-    code_expr(c, expr, &pv);
-    rvalue(c, &pv);
-}
-
-/* code_expr - generate code for an expression parse tree */
-static void code_expr(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
-{
-    switch (expr->nodeType) {
-    case NodeTypeSymbolRef:
-        pv->u.hValue = expr->u.symbolRef.symbol;
-        pv->fcn = expr->u.symbolRef.fcn;
-        break;
-    case NodeTypeStringLit:
-        putcbyte(c, OP_LITH);
-        putcword(c, (VMUVALUE)expr->u.stringLit.string);
-        pv->fcn = NULL;
-        break;
-    case NodeTypeIntegerLit:
-        putcbyte(c, OP_LIT);
-        putcword(c, expr->u.integerLit.value);
-        pv->fcn = NULL;
-        break;
-    case NodeTypeHandleLit:
-        putcbyte(c, OP_LITH);
-        putcword(c, (VMUVALUE)expr->u.handleLit.handle);
-        pv->fcn = NULL;
-        break;
-    case NodeTypeUnaryOp:
-        code_rvalue(c, expr->u.unaryOp.expr);
-        putcbyte(c, expr->u.unaryOp.op);
-        pv->fcn = NULL;
-        break;
-    case NodeTypeBinaryOp:
-        code_rvalue(c, expr->u.binaryOp.left);
-        code_rvalue(c, expr->u.binaryOp.right);
-        putcbyte(c, expr->u.binaryOp.op);
-        pv->fcn = NULL;
-        break;
-    case NodeTypeArrayRef:
-        code_arrayref(c, expr, pv);
-        break;
-    case NodeTypeFunctionCall:
-        code_call(c, expr, pv);
-        break;
-    case NodeTypeDisjunction:
-        code_shortcircuit(c, OP_BRTSC, expr, pv);
-        break;
-    case NodeTypeConjunction:
-        code_shortcircuit(c, OP_BRFSC, expr, pv);
-        break;
-    }
-}
-
-/* code_shortcircuit - generate code for a conjunction or disjunction of boolean expressions */
-static void code_shortcircuit(ParseContext *c, int op, ParseTreeNode *expr, PVAL *pv)
-{
-    ExprListEntry *entry = expr->u.exprList.exprs.head;
-    int end = 0;
-
-    code_rvalue(c, entry->expr);
-    entry = entry->next;
-
-    do {
-        putcbyte(c, op);
-        end = putcword(c, end);
-        code_rvalue(c, entry->expr);
-    } while ((entry = entry->next) != NULL);
-
-    fixupbranch(c, end, codeaddr(c));
-
-    pv->fcn = NULL;
-}
-
-/* code_arrayref - code an array reference */
-static void code_arrayref(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
-{
-    /* code the array */
-    code_rvalue(c, expr->u.arrayRef.array);
-
-    /* code the first index */
-    code_rvalue(c, expr->u.arrayRef.index);
-
-    /* setup the element type */
-    pv->fcn = code_index;
-}
-
-/* code_call - code a function call */
-static void code_call(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
-{
-    ExprListEntry *arg;
-
-    /* code each argument expression */
-    for (arg = expr->u.functionCall.args.tail; arg != NULL; arg = arg->prev)
-        code_rvalue(c, arg->expr);
-
-    /* get the value of the function */
-    code_rvalue(c, expr->u.functionCall.fcn);
-
-    /* call the function */
-    putcbyte(c, OP_CALL);
-
-    /* we've got an rvalue now */
-    pv->fcn = NULL;
-}
-
-/* rvalue - get the rvalue of a partial expression */
-void rvalue(ParseContext *c, PVAL *pv)
-{
-    if (pv->fcn) {
-        (*pv->fcn)(c, PV_LOAD, pv);
-        pv->fcn = NULL;
-    }
-}
-
-/* chklvalue - make sure we've got an lvalue */
-void chklvalue(ParseContext *c, PVAL *pv)
-{
-    if (pv->fcn == NULL)
-        ParseError(c,"Expecting an lvalue", NULL);
-}
-
-/* code_global - compile a global variable reference */
-void code_global(ParseContext *c, PValOp fcn, PVAL *pv)
-{
-    Symbol *sym = GetSymbolPtr(pv->u.hValue);
-    switch (fcn) {
-    case PV_LOAD:
-        putcbyte(c, IsHandleType(sym->type) ? OP_GREFH : OP_GREF);
-        putcword(c, (VMUVALUE)pv->u.hValue);
-        break;
-    case PV_STORE:
-        putcbyte(c, IsHandleType(sym->type) ? OP_GSETH : OP_GSET);
-        putcword(c, (VMUVALUE)pv->u.hValue);
-        break;
-    }
-}
-
-/* code_local - compile an local reference */
-void code_local(ParseContext *c, PValOp fcn, PVAL *pv)
-{
-    Local *sym = GetLocalPtr(pv->u.hValue);
-    switch (fcn) {
-    case PV_LOAD:
-        putcbyte(c, IsHandleType(sym->type) ? OP_LREFH : OP_LREF);
-        putcbyte(c, sym->offset);
-        break;
-    case PV_STORE:
-        putcbyte(c, IsHandleType(sym->type) ? OP_LSETH : OP_LSET);
-        putcbyte(c, sym->offset);
-        break;
-    }
-}
-
-/* code_index - compile a vector reference */
-static void code_index(ParseContext *c, PValOp fcn, PVAL *pv)
-{
-    switch (fcn) {
-    case PV_LOAD:
-        putcbyte(c, OP_VREF);
-        break;
-    case PV_STORE:
-        putcbyte(c, OP_VSET);
-        break;
-    }
-}
-
-/* codeaddr - get the current code address (actually, offset) */
-int codeaddr(ParseContext *c)
-{
-    return (int)(c->cptr - c->codeBuf);
-}
-
-/* putcbyte - put a code byte into the code buffer */
-int putcbyte(ParseContext *c, int b)
-{
-    int addr = codeaddr(c);
-    if (c->cptr >= c->ctop)
-        Abort(c->sys, "bytecode buffer overflow");
-    *c->cptr++ = b;
-    return addr;
-}
-
-/* putcword - put a code word into the code buffer */
-int putcword(ParseContext *c, VMVALUE w)
-{
-    int addr = codeaddr(c);
-    if (c->cptr + sizeof(VMVALUE) > c->ctop)
-        Abort(c->sys, "bytecode buffer overflow");
-    wr_cword(c, (VMUVALUE)(c->cptr - c->codeBuf), w);
-    c->cptr += sizeof(VMVALUE);
-    return addr;
-}
-
-/* rd_cword - get a code word from the code buffer */
-VMVALUE rd_cword(ParseContext *c, VMUVALUE off)
-{
-    uint8_t *p = &c->codeBuf[off] + sizeof(VMVALUE);
-    int cnt = sizeof(VMVALUE);
-    VMVALUE w = 0;
-    while (--cnt >= 0) {
-        w <<= 8;
-        w |= *--p;
-    }
-    return w;
-}
-
-/* wr_cword - put a word into the code buffer */
-void wr_cword(ParseContext *c, VMUVALUE off, VMVALUE v)
-{
-    int i;
-    union {
-        VMVALUE value;
-        uint8_t bytes[sizeof(VMVALUE)];
-    } u;
-    u.value = v;
-    for (i = 0; i < sizeof(u.bytes); ++i)
-       c->codeBuf[off++] = u.bytes[i];
-}
-
-/* merge - merge two reference chains */
-int merge(ParseContext *c, VMUVALUE chn, VMUVALUE chn2)
-{
-    int last, nxt;
-
-    /* if the chain we're adding is empty, just return the original chain */
-    if (!chn2)
-        return chn;
-
-    /* find the last entry in the new chain */
-    last = chn2;
-    while (last != 0) {
-        if (!(nxt = rd_cword(c, last)))
-            break;
-        last = nxt;
-    }
-
-    /* link the last entry in the new chain to the first entry in the original chain */
-    wr_cword(c, last, chn);
-
-    /* return the new chain now linked to the original chain */
-    return chn2;
-}
-
-/* fixup - fixup a reference chain */
-void fixup(ParseContext *c, VMUVALUE chn, VMUVALUE val)
-{
-    while (chn != 0) {
-        int nxt = rd_cword(c, chn);
-        wr_cword(c, chn, val);
-        chn = nxt;
-    }
-}
-
-/* fixupbranch - fixup a reference chain */
-void fixupbranch(ParseContext *c, VMUVALUE chn, VMUVALUE val)
-{
-    while (chn != 0) {
-        int nxt = rd_cword(c, chn);
-        int off = val - (chn + sizeof(VMUVALUE)); /* this assumes all 1+sizeof(VMUVALUE) byte branch instructions */
-        wr_cword(c, chn, off);
-        chn = nxt;
-    }
-}
+/* db_generate.c - code generation functions
+ *
+ * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#include "db_compiler.h"
+
+/* local function prototypes */
+static void code_expr(ParseContext *c, ParseTreeNode *expr, PVAL *pv);
+static void code_shortcircuit(ParseContext *c, int op, ParseTreeNode *expr, PVAL *pv);
+static int code_append(ParseContext *c, ParseTreeNode *lvalue, ParseTreeNode *expr);
+static int code_callsfunction(ParseTreeNode *expr);
+static void code_cat(ParseContext *c, ParseTreeNode *expr);
+static void code_catoperands(ParseContext *c, ParseTreeNode *expr, int *pCount);
+static void code_arrayref(ParseContext *c, ParseTreeNode *expr, PVAL *pv);
+static void code_call(ParseContext *c, ParseTreeNode *expr, PVAL *pv);
+static int code_inline(ParseContext *c, ParseTreeNode *expr);
+static uint8_t *inlinebody(VMHANDLE code, int *pWritten);
+static void code_inlinearg(ParseContext *c, ParseTreeNode *arg, int offset);
+static void code_index(ParseContext *c, PValOp fcn, PVAL *pv);
+static void code_uindex(ParseContext *c, PValOp fcn, PVAL *pv);
+static Block *inbounds(ParseContext *c, ParseTreeNode *array, ParseTreeNode *index);
+static int lastop(ParseContext *c, int n);
+static int opsize(int op);
+static void forgetops(ParseContext *c);
+static void typeeffect(ParseContext *c, ParseTreeNode *expr, int n);
+
+/* inlining limits (see code_inline) */
+#define MAXINLINE       32      /* most bytes in the body of an inlined function */
+#define MAXINLINEARGS   8       /* most arguments of an inlined function */
+
+/* most strings to join with a single OP_CATN (see code_cat) */
+#define MAXCATN         16
+
+/* branch conditions of the combined compare and branch instructions indexed by OP_xx - OP_LT */
+static int invertedCondition[] = {
+    OP_GE - OP_LT,  /* OP_LT */
+    OP_GT - OP_LT,  /* OP_LE */
+    OP_NE - OP_LT,  /* OP_EQ */
+    OP_EQ - OP_LT,  /* OP_NE */
+    OP_LT - OP_LT,  /* OP_GE */
+    OP_LE - OP_LT   /* OP_GT */
+};
+
+/* code_lvalue - generate code for an l-value expression */
+void code_lvalue(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
+{
+    code_expr(c, expr, pv);
+    chklvalue(c, pv);
+}
+
+/* code_assignment - generate code to assign the value of an expression to an l-value expression */
+void code_assignment(ParseContext *c, ParseTreeNode *lvalue, ParseTreeNode *expr)
+{
+    PVAL pv;
+    code_lvalue(c, lvalue, &pv);
+    if (!code_append(c, lvalue, expr)) {
+        code_rvalue(c, expr);
+        (*pv.fcn)(c, PV_STORE, &pv);
+    }
+}
+
+/* code_append - generate code for v$ = v$ + ... as an append to v$
+ *
+ * OP_GAPPH and OP_LAPPH can extend the string in place instead of copying
+ * all of it (see StringAppend in db_vmint.c). The rest of the expression is
+ * evaluated before the variable is read so it can't call a function that
+ * might change a global variable. Returns VMFALSE if the assignment isn't
+ * an append.
+ */
+static int code_append(ParseContext *c, ParseTreeNode *lvalue, ParseTreeNode *expr)
+{
+    ParseTreeNode *node, *first;
+    
+    /* only a string variable can be appended to */
+    if (lvalue->nodeType != NodeTypeSymbolRef
+    ||  GetTypePtr(lvalue->type)->id != TYPE_STRING
+    ||  expr->nodeType != NodeTypeBinaryOp
+    ||  expr->u.binaryOp.op != OP_CAT)
+        return VMFALSE;
+
+    /* find the concatenation with the first operand */
+    for (node = expr; (first = node->u.binaryOp.left)->nodeType == NodeTypeBinaryOp && first->u.binaryOp.op == OP_CAT; node = first)
+        ;
+
+    /* the first operand must be the variable itself */
+    if (first->nodeType != NodeTypeSymbolRef
+    ||  first->u.symbolRef.symbol != lvalue->u.symbolRef.symbol
+    ||  first->u.symbolRef.fcn != lvalue->u.symbolRef.fcn
+    ||  (lvalue->u.symbolRef.fcn == code_global && code_callsfunction(expr)))
+        return VMFALSE;
+
+    /* drop the first operand from the expression and push the rest */
+    *node = *node->u.binaryOp.right;
+    code_rvalue(c, expr);
+
+    /* append it to the variable */
+    if (lvalue->u.symbolRef.fcn == code_global) {
+        putcbyte(c, OP_GAPPH);
+        putcword(c, HandleToValue(lvalue->u.symbolRef.symbol));
+    }
+    else {
+        putcop(c, OP_LAPPH);
+        putcbyte(c, GetLocalPtr(lvalue->u.symbolRef.symbol)->offset);
+    }
+    stackeffect(c, 0, -1);
+
+    return VMTRUE;
+}
+
+/* code_callsfunction - check to see if an expression calls anything but an intrinsic function */
+static int code_callsfunction(ParseTreeNode *expr)
+{
+    ExprListEntry *entry;
+    ParseTreeNode *fcn;
+    switch (expr->nodeType) {
+    case NodeTypeUnaryOp:
+        return code_callsfunction(expr->u.unaryOp.expr);
+    case NodeTypeBinaryOp:
+        return code_callsfunction(expr->u.binaryOp.left) || code_callsfunction(expr->u.binaryOp.right);
+    case NodeTypeArrayRef:
+        return code_callsfunction(expr->u.arrayRef.array) || code_callsfunction(expr->u.arrayRef.index);
+    case NodeTypeFunctionCall:
+        fcn = expr->u.functionCall.fcn;
+        if (fcn->nodeType != NodeTypeHandleLit || GetHeapObjType(fcn->u.handleLit.handle) != ObjTypeIntrinsic)
+            return VMTRUE;
+        for (entry = expr->u.functionCall.args.head; entry != NULL; entry = entry->next)
+            if (code_callsfunction(entry->expr))
+                return VMTRUE;
+        break;
+    case NodeTypeDisjunction:
+    case NodeTypeConjunction:
+        for (entry = expr->u.exprList.exprs.head; entry != NULL; entry = entry->next)
+            if (code_callsfunction(entry->expr))
+                return VMTRUE;
+        break;
+    default:
+        break;
+    }
+    return VMFALSE;
+}
+
+/* code_rvalue - generate code for an r-value expression */
+void code_rvalue(ParseContext *c, ParseTreeNode *expr)
+{
+    PVAL pv;
+    code_expr(c, expr, &pv);
+    rvalue(c, &pv);
+}
+
+/* code_expr - generate code for an expression parse tree */
+static void code_expr(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
+{
+    switch (expr->nodeType) {
+    case NodeTypeSymbolRef:
+        pv->u.hValue = expr->u.symbolRef.symbol;
+        pv->fcn = expr->u.symbolRef.fcn;
+        break;
+    case NodeTypeStringLit:
+        putcbyte(c, OP_LITH);
+        putcword(c, HandleToValue(expr->u.stringLit.string));
+        stackeffect(c, 0, 1);
+        pv->fcn = NULL;
+        break;
+    case NodeTypeIntegerLit:
+        putcop(c, OP_LIT);
+        putcword(c, expr->u.integerLit.value);
+        stackeffect(c, 1, 0);
+        pv->fcn = NULL;
+        break;
+    case NodeTypeHandleLit:
+        putcbyte(c, OP_LITH);
+        putcword(c, HandleToValue(expr->u.handleLit.handle));
+        stackeffect(c, 0, 1);
+        pv->fcn = NULL;
+        break;
+    case NodeTypeUnaryOp:
+        code_rvalue(c, expr->u.unaryOp.expr);
+        putcbyte(c, expr->u.unaryOp.op);
+        pv->fcn = NULL;
+        break;
+    case NodeTypeBinaryOp:
+        if (expr->u.binaryOp.op == OP_CAT) {
+            code_cat(c, expr);
+            pv->fcn = NULL;
+            break;
+        }
+        code_rvalue(c, expr->u.binaryOp.left);
+        code_rvalue(c, expr->u.binaryOp.right);
+        if (expr->u.binaryOp.left->type && IsHandleType(expr->u.binaryOp.left->type)) {
+            /* strings have their own comparison instruction */
+            putcbyte(c, OP_SCMP);
+            putcbyte(c, expr->u.binaryOp.op);
+        }
+        else
+            putcop(c, expr->u.binaryOp.op);
+        typeeffect(c, expr->u.binaryOp.left, -1);
+        typeeffect(c, expr->u.binaryOp.right, -1);
+        stackeffect(c, 1, 0);
+        pv->fcn = NULL;
+        break;
+    case NodeTypeArrayRef:
+        code_arrayref(c, expr, pv);
+        break;
+    case NodeTypeFunctionCall:
+        code_call(c, expr, pv);
+        break;
+    case NodeTypeDisjunction:
+        code_shortcircuit(c, OP_BRTSC, expr, pv);
+        break;
+    case NodeTypeConjunction:
+        code_shortcircuit(c, OP_BRFSC, expr, pv);
+        break;
+    }
+}
+
+/* code_shortcircuit - generate code for a conjunction or disjunction of boolean expressions */
+static void code_shortcircuit(ParseContext *c, int op, ParseTreeNode *expr, PVAL *pv)
+{
+    ExprListEntry *entry = expr->u.exprList.exprs.head;
+    int end = 0;
+
+    code_rvalue(c, entry->expr);
+    entry = entry->next;
+
+    do {
+        putcbyte(c, op);
+        end = putcword(c, end);
+        stackeffect(c, -1, 0);
+        code_rvalue(c, entry->expr);
+    } while ((entry = entry->next) != NULL);
+
+    fixupbranch(c, end, codeaddr(c));
+
+    pv->fcn = NULL;
+}
+
+/* code_cat - generate code for a chain of string concatenations
+ *
+ * The parser builds a$+b$+c$ as (a$+b$)+c$ which would make a new string
+ * for each +. Instead all of the operands are pushed and joined by a single
+ * OP_CATN that allocates and copies the result once.
+ */
+static void code_cat(ParseContext *c, ParseTreeNode *expr)
+{
+    int count = 0;
+    code_catoperands(c, expr, &count);
+    if (count == 2)
+        putcbyte(c, OP_CAT);
+    else {
+        putcbyte(c, OP_CATN);
+        putcbyte(c, count);
+    }
+    stackeffect(c, 0, 1 - count);
+}
+
+/* code_catoperands - push the operands of a chain of string concatenations */
+static void code_catoperands(ParseContext *c, ParseTreeNode *expr, int *pCount)
+{
+    if (expr->nodeType == NodeTypeBinaryOp && expr->u.binaryOp.op == OP_CAT) {
+        code_catoperands(c, expr->u.binaryOp.left, pCount);
+        code_catoperands(c, expr->u.binaryOp.right, pCount);
+    }
+    else {
+        /* join what there is so far to keep the handle stack from getting too deep */
+        if (*pCount == MAXCATN) {
+            putcbyte(c, OP_CATN);
+            putcbyte(c, MAXCATN);
+            stackeffect(c, 0, 1 - MAXCATN);
+            *pCount = 1;
+        }
+        code_rvalue(c, expr);
+        ++*pCount;
+    }
+}
+
+/* code_arrayref - code an array reference
+ *
+ * An index that an enclosing FOR loop keeps inside the array gets the
+ * unchecked vector opcodes. The loop remembers where they are in case
+ * its control variable might change later in the body (see uncheck) or
+ * its range turns out to need checking at run time (see ParseNext).
+ */
+static void code_arrayref(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
+{
+    /* code the array */
+    code_rvalue(c, expr->u.arrayRef.array);
+
+    /* code the first index */
+    code_rvalue(c, expr->u.arrayRef.index);
+
+    /* use the unchecked opcodes if a loop proves the index is in bounds */
+    if ((pv->u.block = inbounds(c, expr->u.arrayRef.array, expr->u.arrayRef.index)) != NULL)
+        pv->fcn = code_uindex;
+
+    /* otherwise, setup the element type */
+    else {
+        pv->u.hValue = expr->type ? expr->type : CommonType(c->heap, integerType);
+        pv->fcn = code_index;
+    }
+}
+
+/* inbounds - find the FOR loop that keeps an index within an integer array */
+static Block *inbounds(ParseContext *c, ParseTreeNode *array, ParseTreeNode *index)
+{
+    Symbol *sym;
+    VMVALUE var;
+    Block *b;
+    int op;
+
+    /* the array must be a global integer array */
+    if (array->nodeType != NodeTypeSymbolRef || array->u.symbolRef.fcn != code_global)
+        return NULL;
+    sym = GetSymbolPtr(array->u.symbolRef.symbol);
+    if (GetTypePtr(sym->type)->id != TYPE_ARRAY
+    ||  !sym->v.hValue
+    ||  GetHeapObjType(sym->v.hValue) != ObjTypeIntegerVector)
+        return NULL;
+
+    /* the index must be a numeric variable */
+    if (index->nodeType != NodeTypeSymbolRef || IsHandleType(index->type))
+        return NULL;
+    if (index->u.symbolRef.fcn == code_local) {
+        op = OP_NEXTL;
+        var = GetLocalPtr(index->u.symbolRef.symbol)->offset;
+    }
+    else if (index->u.symbolRef.fcn == code_global) {
+        op = OP_NEXTG;
+        var = (VMVALUE)HandleToValue(index->u.symbolRef.symbol);
+    }
+    else
+        return NULL;
+
+    /* find the innermost loop with that control variable and check its range */
+    for (b = c->bptr; b >= c->blockBuf; --b) {
+        if (b->type == BLOCK_FOR && b->u.ForBlock.op == op && b->u.ForBlock.var == var) {
+            if (b->u.ForBlock.low >= 0
+            &&  b->u.ForBlock.low <= b->u.ForBlock.high
+            &&  b->u.ForBlock.high < (VMVALUE)GetHeapObjSize(sym->v.hValue))
+                return b;
+
+            /* or leave it to the loop's run time range check if that is for this array */
+            if (b->u.ForBlock.guarded
+            &&  (!b->u.ForBlock.array || b->u.ForBlock.array == array->u.symbolRef.symbol)
+            &&  (b->u.ForBlock.step <= 0
+            ||   GetHeapObjSize(sym->v.hValue) + (VMUVALUE)b->u.ForBlock.step <= ((VMUVALUE)~0 >> 1))) {
+                b->u.ForBlock.array = array->u.symbolRef.symbol;
+                return b;
+            }
+            break;
+        }
+    }
+
+    /* no proof */
+    return NULL;
+}
+
+/* code_call - code a function call */
+static void code_call(ParseContext *c, ParseTreeNode *expr, PVAL *pv)
+{
+    ParseTreeNode *fcn = expr->u.functionCall.fcn;
+    int index = fcn->nodeType == NodeTypeHandleLit ? IntrinsicIndex(c->heap, fcn->u.handleLit.handle) : -1;
+    ExprListEntry *arg;
+    int addr;
+
+    /* anything but an intrinsic might change a global FOR loop control variable */
+    if (fcn->nodeType != NodeTypeHandleLit || GetHeapObjType(fcn->u.handleLit.handle) != ObjTypeIntrinsic)
+        uncheck(c, OP_NEXTG, 0);
+
+    /* copy the body of a small function instead of calling it */
+    if (code_inline(c, expr)) {
+        pv->fcn = NULL;
+        return;
+    }
+
+    /* code each argument expression */
+    for (arg = expr->u.functionCall.args.tail; arg != NULL; arg = arg->prev)
+        code_rvalue(c, arg->expr);
+
+    /* call an intrinsic directly through the intrinsic table */
+    if (index >= 0) {
+        putcbyte(c, OP_CALLI);
+        putcbyte(c, index);
+    }
+
+    /* otherwise, get the value of the function and call it */
+    else {
+        code_rvalue(c, fcn);
+        addr = putcbyte(c, OP_CALL);
+        stackeffect(c, 0, -1);
+
+        /* code_tailcall might turn a call to a user function into a tail call */
+        if (fcn->nodeType == NodeTypeHandleLit && GetHeapObjType(fcn->u.handleLit.handle) == ObjTypeCode)
+            c->callAddr = addr;
+    }
+
+    /* the arguments are replaced by the return value */
+    for (arg = expr->u.functionCall.args.head; arg != NULL; arg = arg->next)
+        typeeffect(c, arg->expr, -1);
+    if (expr->type)
+        typeeffect(c, expr, 1);
+
+    /* we've got an rvalue now */
+    pv->fcn = NULL;
+}
+
+/* code_inline - code a call to a small function by copying its body
+ *
+ * The body comes from the code object the call would have run. Callers are
+ * bound to that object when they are compiled and RUN compiles the whole
+ * program again so redefining the function can't leave a stale copy
+ * behind. Literal and local arguments the body doesn't assign are used in
+ * place and the rest are stored in locals set aside for inlined arguments.
+ */
+static int code_inline(ParseContext *c, ParseTreeNode *expr)
+{
+    ParseTreeNode *fcn = expr->u.functionCall.fcn;
+    ParseTreeNode *args[MAXINLINEARGS];
+    int offsets[MAXINLINEARGS];
+    int written, count, temps, depth, hdepth, n, op;
+    uint8_t *base, *end, *p;
+    ExprListEntry *arg;
+
+    /* make sure the function can be inlined */
+    if (fcn->nodeType != NodeTypeHandleLit
+    ||  GetHeapObjType(fcn->u.handleLit.handle) != ObjTypeCode
+    ||  !(base = inlinebody(fcn->u.handleLit.handle, &written)))
+        return VMFALSE;
+    end = base + GetHeapObjSize(fcn->u.handleLit.handle) - 1;
+
+    /* decide which arguments need a local */
+    for (arg = expr->u.functionCall.args.head, count = temps = 0; arg != NULL; arg = arg->next, ++count) {
+        args[count] = arg->expr;
+        if (!(written & (1 << count))
+        &&  (arg->expr->nodeType == NodeTypeIntegerLit
+        ||  (arg->expr->nodeType == NodeTypeSymbolRef && arg->expr->u.symbolRef.fcn == code_local)))
+            offsets[count] = 0;
+        else
+            offsets[count] = ++temps;
+    }
+
+    /* set aside more locals if there aren't enough */
+    if (temps > c->inlineTempCount) {
+        n = c->inlineTempCount > 0 && c->localOffset == c->inlineTemp - c->inlineTempCount;
+        if (c->localOffset - temps < -128)
+            return VMFALSE;
+        if (n)
+            c->localOffset = c->inlineTemp - temps;
+        else {
+            c->inlineTemp = c->localOffset;
+            c->localOffset -= temps;
+        }
+        c->inlineTempCount = temps;
+    }
+    for (n = 0; n < count; ++n)
+        if (offsets[n])
+            offsets[n] = c->inlineTemp - (offsets[n] - 1);
+
+    /* store the arguments that need a local in the order the call would evaluate them */
+    for (n = count; --n >= 0; )
+        if (offsets[n])
+            code_rvalue(c, args[n]);
+    for (n = 0; n < count; ++n)
+        if (offsets[n]) {
+            putcop(c, OP_LSET);
+            putcbyte(c, offsets[n]);
+            stackeffect(c, -1, 0);
+        }
+
+    /* copy the body with the arguments replaced */
+    depth = VMCODEBYTE(base + FD_DEPTH);
+    hdepth = VMCODEBYTE(base + FD_HDEPTH);
+    stackeffect(c, depth, hdepth);
+    for (p = base + FD_SIZE; p < end; p += InstructionSize(op)) {
+        switch (op = VMCODEBYTE(p)) {
+        case OP_LREF:
+            n = (int8_t)VMCODEBYTE(p + 1);
+            code_inlinearg(c, args[n], offsets[n]);
+            break;
+        case OP_LREF2:
+            n = (int8_t)VMCODEBYTE(p + 1);
+            code_inlinearg(c, args[n], offsets[n]);
+            n = (int8_t)VMCODEBYTE(p + 2);
+            code_inlinearg(c, args[n], offsets[n]);
+            break;
+        case OP_LSET:
+        case OP_LTEE:
+        case OP_LINC:
+            putcop(c, op);
+            putcbyte(c, offsets[(int8_t)VMCODEBYTE(p + 1)]);
+            for (n = 2; n < InstructionSize(op); ++n)
+                putcbyte(c, VMCODEBYTE(p + n));
+            break;
+        default:
+            putcop(c, op);
+            for (n = 1; n < InstructionSize(op); ++n)
+                putcbyte(c, VMCODEBYTE(p + n));
+            break;
+        }
+    }
+    stackeffect(c, (VMCODEBYTE(end) == OP_RETURN) - depth, -hdepth);
+
+    return VMTRUE;
+}
+
+/* inlinebody - get the code of a function if it is small enough to inline
+ *
+ * Only a function without handle arguments or locals whose body is a
+ * straight line of value instructions ending in its return can be inlined.
+ * The arguments the body assigns are returned as a bit mask.
+ */
+static uint8_t *inlinebody(VMHANDLE code, int *pWritten)
+{
+    uint8_t *base, *end, *p;
+    int size, args, op, n;
+
+    /* check the size and the frame descriptor (a function calling itself hasn't been stored yet) */
+    if ((size = GetHeapObjSize(code)) <= FD_SIZE || size - FD_SIZE - 1 > MAXINLINE)
+        return NULL;
+    base = GetCodePtr(code);
+    end = base + size - 1;
+    if ((args = VMCODEBYTE(base + FD_ARGS)) > MAXINLINEARGS
+    ||  VMCODEBYTE(base + FD_HARGS) != 0
+    ||  VMCODEBYTE(base + FD_LOCALS) != 0
+    ||  VMCODEBYTE(base + FD_HLOCALS) != 0
+    ||  (VMCODEBYTE(end) != OP_RETURN && VMCODEBYTE(end) != OP_RETURNV))
+        return NULL;
+
+    /* check the instructions */
+    *pWritten = 0;
+    for (p = base + FD_SIZE; p < end; p += InstructionSize(op)) {
+        switch (op = VMCODEBYTE(p)) {
+        case OP_LREF2:
+            if ((n = (int8_t)VMCODEBYTE(p + 2)) < 0 || n >= args)
+                return NULL;
+            /* fall through */
+        case OP_LREF:
+            if ((n = (int8_t)VMCODEBYTE(p + 1)) < 0 || n >= args)
+                return NULL;
+            break;
+        case OP_LSET:
+        case OP_LTEE:
+        case OP_LINC:
+            if ((n = (int8_t)VMCODEBYTE(p + 1)) < 0 || n >= args)
+                return NULL;
+            *pWritten |= 1 << n;
+            break;
+        case OP_NOT:
+        case OP_NEG:
+        case OP_BNOT:
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_REM:
+        case OP_BAND:
+        case OP_BOR:
+        case OP_BXOR:
+        case OP_SHL:
+        case OP_SHR:
+        case OP_LT:
+        case OP_LE:
+        case OP_EQ:
+        case OP_NE:
+        case OP_GE:
+        case OP_GT:
+        case OP_LIT:
+        case OP_ADDI:
+        case OP_GREF:
+        case OP_GSET:
+        case OP_GREFH:
+        case OP_VREF:
+        case OP_VSET:
+        case OP_DROP:
+        case OP_CALLI:
+            break;
+        default:
+            return NULL;
+        }
+    }
+
+    return p == end ? base : NULL;
+}
+
+/* code_inlinearg - code a reference to an argument of an inlined function */
+static void code_inlinearg(ParseContext *c, ParseTreeNode *arg, int offset)
+{
+    if (offset)
+        putcop(c, OP_LREF);
+    else if (arg->nodeType == NodeTypeIntegerLit) {
+        putcop(c, OP_LIT);
+        putcword(c, arg->u.integerLit.value);
+        return;
+    }
+    else {
+        putcop(c, OP_LREF);
+        offset = GetLocalPtr(arg->u.symbolRef.symbol)->offset;
+    }
+    putcbyte(c, offset);
+}
+
+/* rvalue - get the rvalue of a partial expression */
+void rvalue(ParseContext *c, PVAL *pv)
+{
+    if (pv->fcn) {
+        (*pv->fcn)(c, PV_LOAD, pv);
+        pv->fcn = NULL;
+    }
+}
+
+/* chklvalue - make sure we've got an lvalue */
+void chklvalue(ParseContext *c, PVAL *pv)
+{
+    if (pv->fcn == NULL)
+        ParseError(c,"Expecting an lvalue", NULL);
+}
+
+/* code_global - compile a global variable reference */
+void code_global(ParseContext *c, PValOp fcn, PVAL *pv)
+{
+    Symbol *sym = GetSymbolPtr(pv->u.hValue);
+    switch (fcn) {
+    case PV_LOAD:
+        putcbyte(c, IsHandleType(sym->type) ? OP_GREFH : OP_GREF);
+        putcword(c, HandleToValue(pv->u.hValue));
+        stackeffect(c, IsHandleType(sym->type) ? 0 : 1, IsHandleType(sym->type) ? 1 : 0);
+        break;
+    case PV_STORE:
+        if (GetTypePtr(sym->type)->id == TYPE_ARRAY)
+            ParseError(c, "can't assign to an array", NULL);
+        uncheck(c, OP_NEXTG, (VMVALUE)HandleToValue(pv->u.hValue));
+        putcbyte(c, IsHandleType(sym->type) ? OP_GSETH : OP_GSET);
+        putcword(c, HandleToValue(pv->u.hValue));
+        stackeffect(c, IsHandleType(sym->type) ? 0 : -1, IsHandleType(sym->type) ? -1 : 0);
+        break;
+    }
+}
+
+/* code_local - compile an local reference */
+void code_local(ParseContext *c, PValOp fcn, PVAL *pv)
+{
+    Local *sym = GetLocalPtr(pv->u.hValue);
+    VMVALUE value;
+    int addr;
+    switch (fcn) {
+    case PV_LOAD:
+        putcop(c, IsHandleType(sym->type) ? OP_LREFH : OP_LREF);
+        putcbyte(c, sym->offset);
+        stackeffect(c, IsHandleType(sym->type) ? 0 : 1, IsHandleType(sym->type) ? 1 : 0);
+        break;
+    case PV_STORE:
+        uncheck(c, OP_NEXTL, sym->offset);
+
+        /* LREF n; ADDI k; LSET n => LINC n k */
+        if (!IsHandleType(sym->type)
+        &&  lastop(c, 1) == OP_LREF
+        &&  lastop(c, 0) == OP_ADDI
+        &&  c->codeBuf[c->opAddr[1] + 1] == (uint8_t)sym->offset) {
+            addr = c->opAddr[1];
+            value = rd_cword(c, c->opAddr[0] + 1);
+            c->codeBuf[addr] = OP_LINC;
+            wr_cword(c, addr + 2, value);
+            c->cptr = c->codeBuf + addr + 2 + sizeof(VMVALUE);
+            forgetops(c);
+        }
+        else {
+            putcop(c, IsHandleType(sym->type) ? OP_LSETH : OP_LSET);
+            putcbyte(c, sym->offset);
+        }
+        stackeffect(c, IsHandleType(sym->type) ? 0 : -1, IsHandleType(sym->type) ? -1 : 0);
+        break;
+    }
+}
+
+/* code_index - compile a vector reference */
+static void code_index(ParseContext *c, PValOp fcn, PVAL *pv)
+{
+    int handle = IsHandleType(pv->u.hValue);
+    switch (fcn) {
+    case PV_LOAD:
+        putcbyte(c, handle ? OP_VREFH : OP_VREF);
+        stackeffect(c, handle ? -1 : 0, handle ? 0 : -1);
+        break;
+    case PV_STORE:
+        putcbyte(c, handle ? OP_VSETH : OP_VSET);
+        stackeffect(c, handle ? -1 : -2, handle ? -2 : -1);
+        break;
+    }
+}
+
+/* code_uindex - compile a vector reference with an index known to be in bounds */
+static void code_uindex(ParseContext *c, PValOp fcn, PVAL *pv)
+{
+    Block *b = pv->u.block;
+    int addr;
+
+    /* the value stored might have made the loop give up on its range */
+    if ((b->u.ForBlock.high < b->u.ForBlock.low && !b->u.ForBlock.guarded)
+    ||  b->u.ForBlock.uncheckedCount >= MAXUNCHECKED) {
+        pv->u.hValue = CommonType(c->heap, integerType);
+        code_index(c, fcn, pv);
+        return;
+    }
+
+    if (fcn == PV_LOAD) {
+        addr = putcbyte(c, OP_VREFU);
+        stackeffect(c, 0, -1);
+    }
+    else {
+        addr = putcbyte(c, OP_VSETU);
+        stackeffect(c, -2, -1);
+    }
+    b->u.ForBlock.unchecked[b->u.ForBlock.uncheckedCount++] = addr;
+}
+
+/* uncheck - go back to checked vector references in loops whose control variable might change
+ *
+ * The loops are the ones stepped by the NEXT opcode op with the control
+ * variable var. Globals never have a zero handle so a zero var with
+ * OP_NEXTG means any global and a zero op means every enclosing loop.
+ */
+void uncheck(ParseContext *c, int op, VMVALUE var)
+{
+    Block *b;
+    int n;
+    for (b = c->bptr; b >= c->blockBuf; --b) {
+        if (b->type == BLOCK_FOR
+        &&  (!op || (b->u.ForBlock.op == op && (b->u.ForBlock.var == var || (op == OP_NEXTG && !var))))) {
+            for (n = 0; n < b->u.ForBlock.uncheckedCount; ++n) {
+                uint8_t *p = &c->codeBuf[b->u.ForBlock.unchecked[n]];
+                *p = (*p == OP_VREFU ? OP_VREF : OP_VSET);
+            }
+            b->u.ForBlock.uncheckedCount = 0;
+            b->u.ForBlock.low = 0;
+            b->u.ForBlock.high = -1;
+            b->u.ForBlock.guarded = VMFALSE;
+        }
+    }
+}
+
+/* code_reset - empty the code staging buffer */
+void code_reset(ParseContext *c)
+{
+    c->cptr = c->codeBuf;
+    c->labelAddr = 0;
+    c->callAddr = -1;
+    c->inlineTempCount = 0;
+    c->stackDepth = c->maxStackDepth = 0;
+    c->handleDepth = c->maxHandleDepth = 0;
+    forgetops(c);
+}
+
+/* code_tailcall - turn a call to a user function at the end of the code so far into a tail call
+ *
+ * The caller has to know that nothing but returning would follow the call
+ * and that the called function returns the same kind of value as the one
+ * being compiled. Returns VMFALSE if the code doesn't end with such a call.
+ */
+int code_tailcall(ParseContext *c)
+{
+    if (c->callAddr < 0 || c->callAddr != (int)(c->cptr - c->codeBuf) - 1)
+        return VMFALSE;
+    c->codeBuf[c->callAddr] = OP_TCALL;
+    return VMTRUE;
+}
+
+/* stackeffect - keep track of the stack depths as code is generated
+ *
+ * StoreCode puts the most values and handles ever on the stacks into the
+ * frame descriptor so that the interpreter only has to check for stack
+ * overflow once per call. The depths only need to be upper bounds.
+ */
+void stackeffect(ParseContext *c, int values, int handles)
+{
+    if ((c->stackDepth += values) > c->maxStackDepth)
+        c->maxStackDepth = c->stackDepth;
+    if ((c->handleDepth += handles) > c->maxHandleDepth)
+        c->maxHandleDepth = c->handleDepth;
+}
+
+/* typeeffect - keep track of the stack depths as a value of the type of an expression is pushed or popped */
+static void typeeffect(ParseContext *c, ParseTreeNode *expr, int n)
+{
+    if (expr->type && IsHandleType(expr->type))
+        stackeffect(c, 0, n);
+    else
+        stackeffect(c, n, 0);
+}
+
+/* codeaddr - get the current code address (actually, offset)
+ *
+ * The caller might use the address as a branch target so the peephole
+ * optimizer in putcop must not combine instructions across it.
+ */
+int codeaddr(ParseContext *c)
+{
+    int addr = (int)(c->cptr - c->codeBuf);
+    if (addr > c->labelAddr)
+        c->labelAddr = addr;
+    return addr;
+}
+
+/* putcop - put an opcode into the code buffer
+ *
+ * This is also a peephole optimizer that combines the opcode with the
+ * instructions just before it into one of the superinstructions when it
+ * can. The value returned is the address of the opcode. For a combined
+ * branch it is the address just before the branch offset so that callers
+ * can compute branch offsets the same way either way.
+ */
+int putcop(ParseContext *c, int op)
+{
+    VMVALUE value;
+    int cmp, cond, addr;
+
+    switch (op) {
+    case OP_ADD:
+    case OP_SUB:
+        /* LIT k; ADD => ADDI k and LIT k; SUB => ADDI -k */
+        if (lastop(c, 0) == OP_LIT) {
+            addr = c->opAddr[0];
+            value = rd_cword(c, addr + 1);
+            c->codeBuf[addr] = OP_ADDI;
+            wr_cword(c, addr + 1, op == OP_ADD ? value : -value);
+            return addr;
+        }
+        break;
+    case OP_LREF:
+        /* LREF a; LREF b => LREF2 a b */
+        if (lastop(c, 0) == OP_LREF) {
+            addr = c->opAddr[0];
+            c->codeBuf[addr] = OP_LREF2;
+            return addr;
+        }
+        break;
+    case OP_BRT:
+    case OP_BRF:
+        if ((cmp = lastop(c, 0)) >= OP_LT && cmp <= OP_GT) {
+            cond = (op == OP_BRT ? cmp - OP_LT : invertedCondition[cmp - OP_LT]);
+            
+            /* LREF n; LIT k; <cmp>; BRT/BRF => LBR<cond> n k */
+            if (lastop(c, 2) == OP_LREF && lastop(c, 1) == OP_LIT) {
+                addr = c->opAddr[2];
+                value = rd_cword(c, c->opAddr[1] + 1);
+                c->codeBuf[addr] = OP_LBRLT + cond;
+                wr_cword(c, addr + 2, value);
+                c->cptr = c->codeBuf + addr + 2 + sizeof(VMVALUE);
+                forgetops(c);
+                return addr + 1 + sizeof(VMVALUE);
+            }
+            
+            /* <cmp>; BRT/BRF => BR<cond> */
+            addr = c->opAddr[0];
+            c->codeBuf[addr] = OP_BRLT + cond;
+            forgetops(c);
+            return addr;
+        }
+        break;
+    }
+    
+    /* remember where the instruction starts */
+    c->opAddr[2] = c->opAddr[1];
+    c->opAddr[1] = c->opAddr[0];
+    c->opAddr[0] = (int)(c->cptr - c->codeBuf);
+    
+    return putcbyte(c, op);
+}
+
+/* lastop - get the opcode of the nth most recent instruction
+ *
+ * Returns -1 unless that instruction and the ones following it are contiguous
+ * with the end of the code and none of them are branch targets.
+ */
+static int lastop(ParseContext *c, int n)
+{
+    int end = (int)(c->cptr - c->codeBuf);
+    int addr, size, i;
+    for (i = 0; i <= n; ++i) {
+        if ((addr = c->opAddr[i]) < 0
+        ||  (size = opsize(c->codeBuf[addr])) == 0
+        ||  addr + size != end)
+            return -1;
+        end = addr;
+    }
+    return c->labelAddr > end ? -1 : c->codeBuf[end];
+}
+
+/* opsize - get the size of an instruction that putcop can combine */
+static int opsize(int op)
+{
+    switch (op) {
+    case OP_LIT:
+    case OP_ADDI:
+        return 1 + sizeof(VMVALUE);
+    case OP_LREF:
+        return 2;
+    case OP_LREF2:
+        return 3;
+    case OP_LT:
+    case OP_LE:
+    case OP_EQ:
+    case OP_NE:
+    case OP_GE:
+    case OP_GT:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* forgetops - forget the recent instructions after combining them */
+static void forgetops(ParseContext *c)
+{
+    c->opAddr[0] = c->opAddr[1] = c->opAddr[2] = -1;
+}
+
+/* putcbyte - put a code byte into the code buffer */
+int putcbyte(ParseContext *c, int b)
+{
+    int addr = (int)(c->cptr - c->codeBuf);
+    if (c->cptr >= c->ctop)
+        Abort(c->sys, "bytecode buffer overflow");
+    *c->cptr++ = b;
+    return addr;
+}
+
+/* putcword - put a code word into the code buffer */
+int putcword(ParseContext *c, VMVALUE w)
+{
+    int addr = (int)(c->cptr - c->codeBuf);
+    if (c->cptr + sizeof(VMVALUE) > c->ctop)
+        Abort(c->sys, "bytecode buffer overflow");
+    wr_cword(c, (VMUVALUE)(c->cptr - c->codeBuf), w);
+    c->cptr += sizeof(VMVALUE);
+    return addr;
+}
+
+/* rd_cword - get a code word from the code buffer */
+VMVALUE rd_cword(ParseContext *c, VMUVALUE off)
+{
+    uint8_t *p = &c->codeBuf[off] + sizeof(VMVALUE);
+    int cnt = sizeof(VMVALUE);
+    VMVALUE w = 0;
+    while (--cnt >= 0) {
+        w <<= 8;
+        w |= *--p;
+    }
+    return w;
+}
+
+/* wr_cword - put a word into the code buffer */
+void wr_cword(ParseContext *c, VMUVALUE off, VMVALUE v)
+{
+    int i;
+    union {
+        VMVALUE value;
+        uint8_t bytes[sizeof(VMVALUE)];
+    } u;
+    u.value = v;
+    for (i = 0; i < sizeof(u.bytes); ++i)
+       c->codeBuf[off++] = u.bytes[i];
+}
+
+/* merge - merge two reference chains */
+int merge(ParseContext *c, VMUVALUE chn, VMUVALUE chn2)
+{
+    int last, nxt;
+
+    /* if the chain we're adding is empty, just return the original chain */
+    if (!chn2)
+        return chn;
+
+    /* find the last entry in the new chain */
+    last = chn2;
+    while (last != 0) {
+        if (!(nxt = rd_cword(c, last)))
+            break;
+        last = nxt;
+    }
+
+    /* link the last entry in the new chain to the first entry in the original chain */
+    wr_cword(c, last, chn);
+
+    /* return the new chain now linked to the original chain */
+    return chn2;
+}
+
+/* fixup - fixup a reference chain */
+void fixup(ParseContext *c, VMUVALUE chn, VMUVALUE val)
+{
+    while (chn != 0) {
+        int nxt = rd_cword(c, chn);
+        wr_cword(c, chn, val);
+        chn = nxt;
+    }
+}
+
+/* fixupbranch - fixup a reference chain */
+void fixupbranch(ParseContext *c, VMUVALUE chn, VMUVALUE val)
+{
+    while (chn != 0) {
+        int nxt = rd_cword(c, chn);
+        int off = val - (chn + sizeof(VMUVALUE)); /* this assumes all 1+sizeof(VMUVALUE) byte branch instructions */
+        wr_cword(c, chn, off);
+        chn = nxt;
+    }
+}
@@ -1,17 +1,17 @@
-/* db_inttypes.h - integer type definitions for a simple virtual machine
- *
- * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
- *
- */
-
-#ifndef __DB_INTTYPES_H__
-#define __DB_INTTYPES_H__
-
-typedef char int8_t;
-typedef unsigned char uint8_t;
-typedef short int16_t;
-typedef unsigned short uint16_t;
-typedef long int32_t;
-typedef unsigned long uint32_t;
-
-#endif
+/* db_inttypes.h - integer type definitions for a simple virtual machine
+ *
+ * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#ifndef __DB_INTTYPES_H__
+#define __DB_INTTYPES_H__
+
+typedef char int8_t;
+typedef unsigned char uint8_t;
+typedef short int16_t;
+typedef unsigned short uint16_t;
+typedef long int32_t;
+typedef unsigned long uint32_t;
+
+#endif
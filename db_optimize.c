@@ -0,0 +1,1104 @@
+/* db_optimize.c - parse tree and bytecode optimizers
+ *
+ * Copyright (c) 2009-2012 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#include <string.h>
+#include "db_compiler.h"
+
+/* instruction flags used by OptimizeCode */
+#define PH_START    0x01    /* first byte of an instruction */
+#define PH_TARGET   0x02    /* target of a branch */
+#define PH_DEAD     0x04    /* deleted */
+#define PH_REACHED  0x08    /* reachable from the start of the code (see DropUnreachable) */
+
+/* most branches to branches to follow when threading a branch */
+#define MAXTHREAD   8
+
+/* limits used by HoistInvariants */
+#define MAXINVARIANTS   16  /* most expressions to move out of a loop at once */
+#define MAXSTORES       16  /* most global stores to track before assuming every global is stored */
+#define MAXHOISTPASSES  32  /* most times to rewrite a code object */
+
+/* kinds of instructions found by InvariantOp */
+#define INV_NONE    0       /* not loop invariant */
+#define INV_LOAD    1       /* literal or load of a variable the loop doesn't store */
+#define INV_OP      2       /* operator or pure intrinsic function */
+#define INV_STROP   3       /* pure intrinsic function or operator that takes strings */
+
+/* loop being searched for invariant expressions */
+typedef struct {
+    int head;                       /* address of the first instruction */
+    int end;                        /* address following the backward branch */
+    int straightEnd;                /* address of the first branch or return */
+    uint8_t localStored[256];       /* value locals the loop stores (indexed by frame offset) */
+    uint8_t handleLocalStored[256]; /* handle locals the loop stores */
+    uint8_t *globalStored[MAXSTORES];   /* symbol operands of the global stores */
+    int globalStoreCount;           /* number of global stores or -1 for any global */
+} Loop;
+
+/* invariant expression found in a loop */
+typedef struct {
+    int start;                      /* address of the first instruction */
+    int end;                        /* address following the last instruction */
+    int handle;                     /* the expression leaves a handle instead of a value */
+    int temp;                       /* local variable holding the value or handle */
+} Invariant;
+
+/* local function prototypes */
+static void OptimizeUnaryOp(ParseContext *c, ParseTreeNode *expr);
+static void OptimizeBinaryOp(ParseContext *c, ParseTreeNode *expr);
+static ParseTreeNode *OptimizeExprList(ParseContext *c, ParseTreeNode *expr, int stop);
+static int FoldBinaryOp(int op, VMVALUE left, VMVALUE right, VMVALUE *pValue);
+static int IsCommutative(int op);
+static int HasSideEffects(ParseTreeNode *expr);
+static int PowerOfTwo(VMVALUE value);
+static void ReplaceNode(ParseTreeNode *expr, ParseTreeNode *node);
+static void MakeIntegerLit(ParseTreeNode *expr, VMVALUE value);
+static int IsBranch(int op);
+static int BranchTarget(ParseContext *c, int addr);
+static void SetBranchTarget(ParseContext *c, int addr, int target);
+static int NextLive(uint8_t *flags, int addr, int size);
+static void Delete(uint8_t *flags, int addr, int size);
+static int Compact(ParseContext *c, uint8_t *flags, int size);
+static int EndsFlow(int op);
+static void ReportUnreachable(ParseContext *c, uint8_t *flags, int base);
+static int HoistLoop(ParseContext *c, Loop *loop, uint8_t *flags);
+static void FindStores(ParseContext *c, Loop *loop);
+static int GlobalStored(Loop *loop, uint8_t *symbol);
+static int InvariantEnd(ParseContext *c, Loop *loop, uint8_t *flags, int start, int *pHandle);
+static int InvariantOp(ParseContext *c, Loop *loop, int addr, int *pDepth, int *pHandleDepth);
+static void MoveInvariants(ParseContext *c, Loop *loop, Invariant *inv, int count);
+
+/* OptimizeExpr - optimize an expression parse tree
+ *
+ * Runs between parsing and code generation. Folds constant subexpressions,
+ * removes identities like x+0 and x*1, turns multiplication by a power of
+ * two into a shift and gathers the constants of a chain like (x+1)+2 into
+ * a single literal. The tree is rewritten in place and the root returned.
+ */
+ParseTreeNode *OptimizeExpr(ParseContext *c, ParseTreeNode *expr)
+{
+    ExprListEntry *entry;
+
+    switch (expr->nodeType) {
+    case NodeTypeUnaryOp:
+        OptimizeUnaryOp(c, expr);
+        break;
+    case NodeTypeBinaryOp:
+        OptimizeBinaryOp(c, expr);
+        break;
+    case NodeTypeArrayRef:
+        expr->u.arrayRef.index = OptimizeExpr(c, expr->u.arrayRef.index);
+        break;
+    case NodeTypeFunctionCall:
+        for (entry = expr->u.functionCall.args.head; entry != NULL; entry = entry->next)
+            entry->expr = OptimizeExpr(c, entry->expr);
+        break;
+    case NodeTypeDisjunction:
+        expr = OptimizeExprList(c, expr, VMTRUE);
+        break;
+    case NodeTypeConjunction:
+        expr = OptimizeExprList(c, expr, VMFALSE);
+        break;
+    default:
+        /* nothing to optimize */
+        break;
+    }
+
+    return expr;
+}
+
+/* OptimizeUnaryOp - optimize a unary operator node */
+static void OptimizeUnaryOp(ParseContext *c, ParseTreeNode *expr)
+{
+    ParseTreeNode *operand = OptimizeExpr(c, expr->u.unaryOp.expr);
+    int op = expr->u.unaryOp.op;
+
+    expr->u.unaryOp.expr = operand;
+
+    /* fold the operator applied to a constant */
+    if (IsIntegerLit(operand)) {
+        VMVALUE value = operand->u.integerLit.value;
+        switch (op) {
+        case OP_NEG:
+            MakeIntegerLit(expr, -value);
+            break;
+        case OP_NOT:
+            MakeIntegerLit(expr, value ? VMFALSE : VMTRUE);
+            break;
+        case OP_BNOT:
+            MakeIntegerLit(expr, ~value);
+            break;
+        }
+    }
+
+    /* -(-x) => x and ~(~x) => x */
+    else if ((op == OP_NEG || op == OP_BNOT)
+         &&  operand->nodeType == NodeTypeUnaryOp
+         &&  operand->u.unaryOp.op == op)
+        ReplaceNode(expr, operand->u.unaryOp.expr);
+}
+
+/* OptimizeBinaryOp - optimize a binary operator node */
+static void OptimizeBinaryOp(ParseContext *c, ParseTreeNode *expr)
+{
+    ParseTreeNode *left, *right, *tmp;
+    VMVALUE value;
+    int op, shift;
+
+    left = expr->u.binaryOp.left = OptimizeExpr(c, expr->u.binaryOp.left);
+    right = expr->u.binaryOp.right = OptimizeExpr(c, expr->u.binaryOp.right);
+    op = expr->u.binaryOp.op;
+
+    /* fold an operator applied to two constants */
+    if (IsIntegerLit(left) && IsIntegerLit(right)) {
+        if (FoldBinaryOp(op, left->u.integerLit.value, right->u.integerLit.value, &value))
+            MakeIntegerLit(expr, value);
+        return;
+    }
+
+    /* move the constant operand of a commutative operator to the right */
+    if (IsIntegerLit(left) && IsCommutative(op)) {
+        expr->u.binaryOp.left = right;
+        expr->u.binaryOp.right = left;
+        tmp = left; left = right; right = tmp;
+    }
+
+    /* everything else needs a constant right operand */
+    if (!IsIntegerLit(right))
+        return;
+    value = right->u.integerLit.value;
+
+    /* x - k => x + -k */
+    if (op == OP_SUB) {
+        expr->u.binaryOp.op = op = OP_ADD;
+        right->u.integerLit.value = value = -value;
+    }
+
+    /* (x op k1) op k2 => x op (k1 op k2) */
+    if (IsCommutative(op)
+    &&  left->nodeType == NodeTypeBinaryOp
+    &&  left->u.binaryOp.op == op
+    &&  IsIntegerLit(left->u.binaryOp.right)) {
+        FoldBinaryOp(op, left->u.binaryOp.right->u.integerLit.value, value, &value);
+        right->u.integerLit.value = value;
+        expr->u.binaryOp.left = left = left->u.binaryOp.left;
+    }
+
+    /* (k1 - x) + k2 => (k1 + k2) - x */
+    else if (op == OP_ADD
+         &&  left->nodeType == NodeTypeBinaryOp
+         &&  left->u.binaryOp.op == OP_SUB
+         &&  IsIntegerLit(left->u.binaryOp.left)) {
+        left->u.binaryOp.left->u.integerLit.value += value;
+        ReplaceNode(expr, left);
+        return;
+    }
+
+    switch (op) {
+    case OP_ADD:
+    case OP_BOR:
+    case OP_BXOR:
+    case OP_SHL:
+    case OP_SHR:
+        /* x + 0, x | 0, x ^ 0, x << 0, x >> 0 => x */
+        if (value == 0)
+            ReplaceNode(expr, left);
+        break;
+    case OP_MUL:
+        /* x * 1 => x */
+        if (value == 1)
+            ReplaceNode(expr, left);
+
+        /* x * 0 => 0 */
+        else if (value == 0) {
+            if (!HasSideEffects(left))
+                MakeIntegerLit(expr, 0);
+        }
+
+        /* x * 2^n => x << n */
+        else if ((shift = PowerOfTwo(value)) > 0) {
+            expr->u.binaryOp.op = OP_SHL;
+            right->u.integerLit.value = shift;
+        }
+        break;
+    case OP_DIV:
+        /* x / 1 => x */
+        if (value == 1)
+            ReplaceNode(expr, left);
+        break;
+    case OP_BAND:
+        /* x & 0 => 0 and x & -1 => x */
+        if (value == 0) {
+            if (!HasSideEffects(left))
+                MakeIntegerLit(expr, 0);
+        }
+        else if (value == -1)
+            ReplaceNode(expr, left);
+        break;
+    }
+}
+
+/* OptimizeExprList - optimize an OR or AND expression list
+ *
+ * The short circuit operators leave the last value they evaluate so a term
+ * that can't stop the evaluation can be dropped. A constant term that always
+ * stops it makes the terms after it dead. 'stop' is the truth value that
+ * stops the evaluation (VMTRUE for OR and VMFALSE for AND).
+ */
+static ParseTreeNode *OptimizeExprList(ParseContext *c, ParseTreeNode *expr, int stop)
+{
+    ExprList *list = &expr->u.exprList.exprs;
+    ExprListEntry *entry, *next;
+
+    for (entry = list->head; entry != NULL; entry = next) {
+        next = entry->next;
+        entry->expr = OptimizeExpr(c, entry->expr);
+        if (IsIntegerLit(entry->expr)) {
+
+            /* drop the terms following one that always stops the evaluation */
+            if ((entry->expr->u.integerLit.value != 0) == stop) {
+                entry->next = NULL;
+                list->tail = entry;
+                break;
+            }
+
+            /* drop a term that never stops it unless it supplies the final value */
+            else if (next || (stop && entry != list->head)) {
+                if (entry->prev)
+                    entry->prev->next = next;
+                else
+                    list->head = next;
+                if (next)
+                    next->prev = entry->prev;
+                else
+                    list->tail = entry->prev;
+            }
+        }
+    }
+
+    /* a list with a single term is just that term */
+    if (list->head == list->tail)
+        return list->head->expr;
+
+    return expr;
+}
+
+/* FoldBinaryOp - compute the value of an operator applied to two constants */
+static int FoldBinaryOp(int op, VMVALUE left, VMVALUE right, VMVALUE *pValue)
+{
+    switch (op) {
+    case OP_ADD:    *pValue = left + right;     break;
+    case OP_SUB:    *pValue = left - right;     break;
+    case OP_MUL:    *pValue = left * right;     break;
+    case OP_DIV:
+        if (right == 0)
+            return VMFALSE;
+        *pValue = left / right;
+        break;
+    case OP_REM:
+        if (right == 0)
+            return VMFALSE;
+        *pValue = left % right;
+        break;
+    case OP_BAND:   *pValue = left & right;     break;
+    case OP_BOR:    *pValue = left | right;     break;
+    case OP_BXOR:   *pValue = left ^ right;     break;
+    case OP_SHL:    *pValue = left << right;    break;
+    case OP_SHR:    *pValue = left >> right;    break;
+    case OP_LT:     *pValue = (left < right ? VMTRUE : VMFALSE);    break;
+    case OP_LE:     *pValue = (left <= right ? VMTRUE : VMFALSE);   break;
+    case OP_EQ:     *pValue = (left == right ? VMTRUE : VMFALSE);   break;
+    case OP_NE:     *pValue = (left != right ? VMTRUE : VMFALSE);   break;
+    case OP_GE:     *pValue = (left >= right ? VMTRUE : VMFALSE);   break;
+    case OP_GT:     *pValue = (left > right ? VMTRUE : VMFALSE);    break;
+    default:
+        return VMFALSE;
+    }
+    return VMTRUE;
+}
+
+/* IsCommutative - check to see if the order of an operator's operands doesn't matter */
+static int IsCommutative(int op)
+{
+    switch (op) {
+    case OP_ADD:
+    case OP_MUL:
+    case OP_BAND:
+    case OP_BOR:
+    case OP_BXOR:
+        return VMTRUE;
+    }
+    return VMFALSE;
+}
+
+/* HasSideEffects - check to see if evaluating an expression can do more than produce a value
+ *
+ * Array references count because they can fail their bounds check.
+ */
+static int HasSideEffects(ParseTreeNode *expr)
+{
+    ExprListEntry *entry;
+    switch (expr->nodeType) {
+    case NodeTypeUnaryOp:
+        return HasSideEffects(expr->u.unaryOp.expr);
+    case NodeTypeBinaryOp:
+        return HasSideEffects(expr->u.binaryOp.left) || HasSideEffects(expr->u.binaryOp.right);
+    case NodeTypeArrayRef:
+    case NodeTypeFunctionCall:
+        return VMTRUE;
+    case NodeTypeDisjunction:
+    case NodeTypeConjunction:
+        for (entry = expr->u.exprList.exprs.head; entry != NULL; entry = entry->next)
+            if (HasSideEffects(entry->expr))
+                return VMTRUE;
+        break;
+    default:
+        break;
+    }
+    return VMFALSE;
+}
+
+/* PowerOfTwo - get n if a value is 2^n or zero if it isn't a power of two greater than one */
+static int PowerOfTwo(VMVALUE value)
+{
+    int n = 0;
+    if (value <= 1 || (value & (value - 1)) != 0)
+        return 0;
+    while ((value >>= 1) != 0)
+        ++n;
+    return n;
+}
+
+/* ReplaceNode - replace a node with another one keeping the type of the original */
+static void ReplaceNode(ParseTreeNode *expr, ParseTreeNode *node)
+{
+    VMHANDLE type = expr->type;
+    *expr = *node;
+    expr->type = type;
+}
+
+/* MakeIntegerLit - turn a node into an integer literal */
+static void MakeIntegerLit(ParseTreeNode *expr, VMVALUE value)
+{
+    expr->nodeType = NodeTypeIntegerLit;
+    expr->u.integerLit.value = value;
+}
+
+/* OptimizeCode - rewrite redundant instruction sequences in the code staging buffer
+ *
+ * Runs in StoreCode once the code is complete so it sees the sequences that
+ * putcop can't, like those spanning statements or a branch target. Deleted
+ * instructions are only marked until nothing more changes and then the code
+ * is compacted and the branch offsets resolved again. A branch to a deleted
+ * instruction goes to the next one that is left. Returns the number of bytes
+ * saved.
+ */
+int OptimizeCode(ParseContext *c)
+{
+    uint8_t *code = c->codeBuf;
+    int size = (int)(c->cptr - c->codeBuf);
+    int addr, next, target, changed, n, op;
+    uint8_t *flags;
+
+    /* find the instructions and the branch targets */
+    flags = (uint8_t *)LocalAlloc(c, size + 1);
+    memset(flags, 0, size + 1);
+    for (addr = FD_SIZE; addr < size; addr += InstructionSize(code[addr])) {
+        flags[addr] |= PH_START;
+        if (IsBranch(code[addr]) && (target = BranchTarget(c, addr)) >= 0 && target <= size)
+            flags[target] |= PH_TARGET;
+    }
+
+    do {
+        changed = VMFALSE;
+        for (addr = NextLive(flags, FD_SIZE, size); addr < size; addr = NextLive(flags, addr + 1, size)) {
+            op = code[addr];
+            next = NextLive(flags, addr + InstructionSize(op), size);
+
+            /* a branch to a BR goes straight to its target */
+            if (IsBranch(op)) {
+                target = NextLive(flags, BranchTarget(c, addr), size);
+                for (n = 0; n < MAXTHREAD && target < size && code[target] == OP_BR; ++n)
+                    target = NextLive(flags, BranchTarget(c, target), size);
+                if (target != BranchTarget(c, addr)) {
+                    SetBranchTarget(c, addr, target);
+                    changed = VMTRUE;
+                }
+            }
+
+            switch (op) {
+            case OP_BR:
+                /* BR to the next instruction => nothing */
+                if ((target = BranchTarget(c, addr)) == next) {
+                    Delete(flags, addr, InstructionSize(op));
+                    changed = VMTRUE;
+                }
+
+                /* BR to a return => the return */
+                else if (target < size
+                     &&  (code[target] == OP_RETURN || code[target] == OP_RETURNH
+                     ||   code[target] == OP_RETURNV || code[target] == OP_HALT)) {
+                    code[addr] = code[target];
+                    Delete(flags, addr + 1, InstructionSize(OP_BR) - 1);
+                    changed = VMTRUE;
+                }
+                break;
+            case OP_NOT:
+                /* NOT; BRF => BRT and NOT; BRT => BRF */
+                if (next < size && !(flags[next] & PH_TARGET)
+                &&  (code[next] == OP_BRF || code[next] == OP_BRT)) {
+                    code[next] = (code[next] == OP_BRF ? OP_BRT : OP_BRF);
+                    Delete(flags, addr, InstructionSize(op));
+                    changed = VMTRUE;
+                }
+                break;
+            case OP_ADDI:
+                /* ADDI 0 => nothing */
+                if (rd_cword(c, addr + 1) == 0) {
+                    Delete(flags, addr, InstructionSize(op));
+                    changed = VMTRUE;
+                }
+                break;
+            case OP_LIT:
+                /* LIT 0; ADD => nothing (and the same for SUB, BOR, BXOR, SHL and SHR) */
+                if (rd_cword(c, addr + 1) == 0 && next < size && !(flags[next] & PH_TARGET)) {
+                    switch (code[next]) {
+                    case OP_ADD:
+                    case OP_SUB:
+                    case OP_BOR:
+                    case OP_BXOR:
+                    case OP_SHL:
+                    case OP_SHR:
+                        Delete(flags, addr, InstructionSize(op));
+                        Delete(flags, next, InstructionSize(code[next]));
+                        changed = VMTRUE;
+                        break;
+                    }
+                }
+                break;
+            case OP_LREF:
+                /* LREF n; LSET n => nothing */
+                if (next < size && !(flags[next] & PH_TARGET)
+                &&  code[next] == OP_LSET && code[next + 1] == code[addr + 1]) {
+                    Delete(flags, addr, InstructionSize(op));
+                    Delete(flags, next, InstructionSize(OP_LSET));
+                    changed = VMTRUE;
+                }
+                break;
+            case OP_LSET:
+                if (next >= size || (flags[next] & PH_TARGET) || code[next + 1] != code[addr + 1])
+                    break;
+
+                /* LSET n; LREF n => LTEE n */
+                if (code[next] == OP_LREF) {
+                    code[addr] = OP_LTEE;
+                    Delete(flags, next, InstructionSize(OP_LREF));
+                    changed = VMTRUE;
+                }
+
+                /* LSET n; LREF2 n m => LTEE n; LREF m */
+                else if (code[next] == OP_LREF2) {
+                    code[addr] = OP_LTEE;
+                    code[next] = OP_LREF;
+                    code[next + 1] = code[next + 2];
+                    Delete(flags, next + 2, 1);
+                    changed = VMTRUE;
+                }
+                break;
+            }
+        }
+    } while (changed);
+
+    return Compact(c, flags, size);
+}
+
+/* DropUnreachable - remove the code that can't be reached from the start of the code staging buffer
+ *
+ * Code following a GOTO, RETURN, STOP or END and the branches of an IF with
+ * a constant condition are generated like any other code but nothing ever
+ * runs them. Each instruction is reached by falling into it or branching to
+ * it so following both from the start finds all of the code that can run.
+ * The rest is deleted and the branches resolved again like in OptimizeCode
+ * and the statements it came from are reported. Returns the number of bytes
+ * removed.
+ */
+int DropUnreachable(ParseContext *c)
+{
+    uint8_t *code = c->codeBuf, *flags;
+    int size = (int)(c->cptr - c->codeBuf);
+    int addr, target, dropped, *work, n;
+
+    /* find the instructions */
+    flags = (uint8_t *)LocalAlloc(c, size + 1);
+    memset(flags, 0, size + 1);
+    for (addr = FD_SIZE; addr < size; addr += InstructionSize(code[addr]))
+        flags[addr] |= PH_START;
+
+    /* follow the flow of control from the start keeping a list of the branch targets still to follow */
+    work = (int *)LocalAlloc(c, (size + 1) * sizeof(int));
+    work[0] = FD_SIZE;
+    n = 1;
+    while (--n >= 0) {
+        for (addr = work[n]; addr < size && !(flags[addr] & PH_REACHED); addr += InstructionSize(code[addr])) {
+            flags[addr] |= PH_REACHED;
+            if (IsBranch(code[addr]) && (target = BranchTarget(c, addr)) >= FD_SIZE && target < size
+            &&  !(flags[target] & PH_REACHED))
+                work[n++] = target;
+            if (EndsFlow(code[addr]))
+                break;
+        }
+    }
+
+    /* delete the instructions that weren't reached */
+    dropped = VMFALSE;
+    for (addr = FD_SIZE; addr < size; addr += InstructionSize(code[addr]))
+        if (!(flags[addr] & PH_REACHED)) {
+            Delete(flags, addr, InstructionSize(code[addr]));
+            dropped = VMTRUE;
+        }
+    if (!dropped)
+        return 0;
+
+    /* the statements of the main code moved when its frame descriptor was added */
+    ReportUnreachable(c, flags, c->codeType == CODE_TYPE_MAIN ? FD_SIZE : 0);
+
+    return Compact(c, flags, size);
+}
+
+/* EndsFlow - check to see if an instruction never continues with the next one */
+static int EndsFlow(int op)
+{
+    switch (op) {
+    case OP_BR:
+    case OP_RETURN:
+    case OP_RETURNH:
+    case OP_RETURNV:
+    case OP_HALT:
+    case OP_TCALL:
+        return VMTRUE;
+    }
+    return VMFALSE;
+}
+
+/* ReportUnreachable - report the statements that generated unreachable code
+ *
+ * A BR that can't be reached is the jump around an ELSE that follows a
+ * RETURN or GOTO so it doesn't count.
+ */
+static void ReportUnreachable(ParseContext *c, uint8_t *flags, int base)
+{
+    StatementCode *stmt, *next, *list = NULL;
+    int size = (int)(c->cptr - c->codeBuf);
+    int lastLine = -1, addr, end;
+
+    /* put the statements in the order they were parsed */
+    for (stmt = c->statements; stmt != NULL; stmt = next) {
+        next = stmt->next;
+        stmt->next = list;
+        list = stmt;
+    }
+    c->statements = list;
+
+    for (stmt = list; stmt != NULL; stmt = stmt->next) {
+        end = stmt->end + base < size ? stmt->end + base : size;
+        for (addr = stmt->start + base; addr < end; ++addr)
+            if ((flags[addr] & (PH_START | PH_DEAD)) == (PH_START | PH_DEAD) && c->codeBuf[addr] != OP_BR) {
+                if (stmt->lineNumber != lastLine)
+                    VM_printf("warning: unreachable code removed\n  line %d\n", stmt->lineNumber);
+                lastLine = stmt->lineNumber;
+                break;
+            }
+    }
+}
+
+/* HoistInvariants - move loop invariant expressions out of the loops in the code staging buffer
+ *
+ * Like OptimizeCode this runs in StoreCode since a one-pass compiler doesn't
+ * know what the rest of a loop stores until it has seen all of it. A loop is
+ * the code from the target of a backward branch through the branch so this
+ * covers FOR/NEXT, DO/LOOP and loops built with GOTO. An expression is
+ * invariant if it is straight line code made of literals, loads of variables
+ * the loop doesn't store, operators and pure intrinsic functions (see
+ * INTRINSIC_PURE in db_vmheap.h). Each one is computed into a new local ahead
+ * of the loop and replaced by a load of that local. A string expression or
+ * the handle of a global array or string gets a new handle local instead,
+ * which keeps its object alive until the code returns. One that allocates a
+ * string can run out of memory there instead of in the loop. The code ahead
+ * of the loop runs at a statement boundary with an empty stack so it never
+ * needs more stack than the expressions did where they were. Loops are tried
+ * from the outermost in so an expression leaves all of the loops it is
+ * invariant in at once. Returns the number of expressions moved.
+ */
+int HoistInvariants(ParseContext *c)
+{
+    uint8_t *code = c->codeBuf, *mark, *flags;
+    int pass, size, addr, target, best, count, moved;
+    Loop *loop;
+    int *loopEnd;
+
+    loop = (Loop *)LocalAlloc(c, sizeof(Loop));
+    mark = c->nextLocal;
+
+    count = 0;
+    for (pass = 0; pass < MAXHOISTPASSES; ++pass) {
+        c->nextLocal = mark;
+        size = (int)(c->cptr - c->codeBuf);
+
+        /* find the instructions, the branch targets and the end of the loop starting at each target */
+        flags = (uint8_t *)LocalAlloc(c, size + 1);
+        memset(flags, 0, size + 1);
+        loopEnd = (int *)LocalAlloc(c, (size + 1) * sizeof(int));
+        memset(loopEnd, 0, (size + 1) * sizeof(int));
+        for (addr = FD_SIZE; addr < size; addr += InstructionSize(code[addr])) {
+            flags[addr] |= PH_START;
+            if (IsBranch(code[addr]) && (target = BranchTarget(c, addr)) >= FD_SIZE && target <= size) {
+                flags[target] |= PH_TARGET;
+                if (target <= addr && addr + InstructionSize(code[addr]) > loopEnd[target])
+                    loopEnd[target] = addr + InstructionSize(code[addr]);
+            }
+        }
+
+        /* try the loops from the longest to the shortest until one changes */
+        moved = 0;
+        for (;;) {
+            best = -1;
+            for (addr = FD_SIZE; addr < size; ++addr)
+                if (loopEnd[addr] > 0 && (best < 0 || loopEnd[addr] - addr > loopEnd[best] - best))
+                    best = addr;
+            if (best < 0)
+                break;
+            loop->head = best;
+            loop->end = loopEnd[best];
+            if ((moved = HoistLoop(c, loop, flags)) > 0)
+                break;
+            loopEnd[best] = 0;
+        }
+        if (moved == 0)
+            break;
+        count += moved;
+    }
+
+    c->nextLocal = mark;
+    return count;
+}
+
+/* HoistLoop - move the invariant expressions out of a loop */
+static int HoistLoop(ParseContext *c, Loop *loop, uint8_t *flags)
+{
+    uint8_t *code = c->codeBuf;
+    int size = (int)(c->cptr - c->codeBuf);
+    Invariant inv[MAXINVARIANTS];
+    int addr, target, end, count, values, handles, n;
+
+    /* the loop has to be entered at the top */
+    for (addr = FD_SIZE; addr < size; addr += InstructionSize(code[addr]))
+        if ((addr < loop->head || addr >= loop->end) && IsBranch(code[addr])
+        &&  (target = BranchTarget(c, addr)) > loop->head && target < loop->end)
+            return 0;
+
+    /* find the invariant expressions */
+    FindStores(c, loop);
+    count = 0;
+    for (addr = loop->head; addr < loop->end && count < MAXINVARIANTS; ) {
+        if ((end = InvariantEnd(c, loop, flags, addr, &inv[count].handle)) > addr) {
+            inv[count].start = addr;
+            inv[count].end = end;
+            ++count;
+            addr = end;
+        }
+        else
+            addr += InstructionSize(code[addr]);
+    }
+
+    /* each one needs a local that a frame offset byte can reach */
+    values = handles = 0;
+    for (n = 0; n < count; ++n)
+        if (inv[n].handle ? c->handleLocalOffset + handles++ > 127 : c->localOffset - values++ < -128)
+            break;
+    count = n;
+
+    /* and adds a store and a load to the code */
+    if (count <= 0 || c->cptr + count * (InstructionSize(OP_LSET) + InstructionSize(OP_LREF)) > c->ctop)
+        return 0;
+    for (n = 0; n < count; ++n)
+        inv[n].temp = inv[n].handle ? c->handleLocalOffset++ : c->localOffset--;
+    code[FD_LOCALS] = (-F_SIZE - 1) - c->localOffset;
+    code[FD_HLOCALS] = c->handleLocalOffset - HF_SIZE - 1;
+
+    MoveInvariants(c, loop, inv, count);
+    return count;
+}
+
+/* FindStores - find the variables stored in a loop and the end of the straight line code at its top */
+static void FindStores(ParseContext *c, Loop *loop)
+{
+    uint8_t *code = c->codeBuf;
+    int addr, op;
+
+    memset(loop->localStored, 0, sizeof(loop->localStored));
+    memset(loop->handleLocalStored, 0, sizeof(loop->handleLocalStored));
+    loop->globalStoreCount = 0;
+    loop->straightEnd = loop->end;
+
+    for (addr = loop->head; addr < loop->end; addr += InstructionSize(op)) {
+        op = code[addr];
+        switch (op) {
+        case OP_LSET:
+        case OP_LTEE:
+        case OP_LINC:
+        case OP_NEXTL:
+            loop->localStored[code[addr + 1]] = VMTRUE;
+            break;
+        case OP_FORL:
+            loop->localStored[code[addr + 1]] = VMTRUE;
+            loop->localStored[code[addr + 2]] = VMTRUE;
+            loop->localStored[(uint8_t)(code[addr + 2] - 1)] = VMTRUE;
+            break;
+        case OP_LSETH:
+        case OP_LAPPH:
+            loop->handleLocalStored[code[addr + 1]] = VMTRUE;
+            break;
+        case OP_FORG:
+            loop->localStored[code[addr + 1 + sizeof(VMVALUE)]] = VMTRUE;
+            loop->localStored[(uint8_t)(code[addr + 1 + sizeof(VMVALUE)] - 1)] = VMTRUE;
+            /* fall through */
+        case OP_NEXTG:
+        case OP_GSET:
+        case OP_GSETH:
+        case OP_GAPPH:
+            if (loop->globalStoreCount >= 0 && loop->globalStoreCount < MAXSTORES)
+                loop->globalStored[loop->globalStoreCount++] = code + addr + 1;
+            else
+                loop->globalStoreCount = -1;
+            break;
+        case OP_CALLI:
+            if (code[addr + 1] < c->heap->nIntrinsics
+            &&  (c->heap->intrinsicInfo[code[addr + 1]].flags & INTRINSIC_PURE))
+                break;
+            /* fall through */
+        case OP_CALL:
+        case OP_TCALL:
+            /* a function can store any global */
+            loop->globalStoreCount = -1;
+            break;
+        }
+
+        /* the code up to the first branch or return runs every time the top of the loop does */
+        if (loop->straightEnd == loop->end
+        &&  (IsBranch(op) || op == OP_RETURN || op == OP_RETURNH || op == OP_RETURNV || op == OP_HALT || op == OP_TCALL))
+            loop->straightEnd = addr;
+    }
+}
+
+/* GlobalStored - check to see if a loop stores a global variable */
+static int GlobalStored(Loop *loop, uint8_t *symbol)
+{
+    int n;
+    if (loop->globalStoreCount < 0)
+        return VMTRUE;
+    for (n = 0; n < loop->globalStoreCount; ++n)
+        if (memcmp(loop->globalStored[n], symbol, sizeof(VMVALUE)) == 0)
+            return VMTRUE;
+    return VMFALSE;
+}
+
+/* InvariantEnd - find the end of the longest invariant expression starting at an address
+ *
+ * The expression has to leave either one value or one handle and nothing
+ * else without using anything that was already on the stacks. A load of a
+ * global handle is worth moving on its own since it takes a symbol lookup
+ * where a handle local doesn't. One that takes strings is only moved from
+ * the straight line code at the top of the loop since a string variable can
+ * still hold a NULL handle that the intrinsic functions can't take until
+ * the code that stores it has run. Sets *pHandle if the expression leaves a
+ * handle. Returns the start address if there isn't one.
+ */
+static int InvariantEnd(ParseContext *c, Loop *loop, uint8_t *flags, int start, int *pHandle)
+{
+    int addr, kind, depth, handleDepth, hasOp, takesStrings, best;
+
+    depth = handleDepth = 0;
+    hasOp = takesStrings = VMFALSE;
+    best = start;
+
+    for (addr = start; addr < loop->end; addr += InstructionSize(c->codeBuf[addr])) {
+        if (addr != start && (flags[addr] & PH_TARGET))
+            break;
+        if ((kind = InvariantOp(c, loop, addr, &depth, &handleDepth)) == INV_NONE)
+            break;
+        if (kind != INV_LOAD || c->codeBuf[addr] == OP_GREFH)
+            hasOp = VMTRUE;
+        if (kind == INV_STROP)
+            takesStrings = VMTRUE;
+        if (depth + handleDepth == 1 && hasOp) {
+            if (takesStrings && addr >= loop->straightEnd)
+                break;
+            best = addr + InstructionSize(c->codeBuf[addr]);
+            *pHandle = handleDepth;
+        }
+    }
+
+    return best;
+}
+
+/* InvariantOp - check an instruction in a loop and apply its stack effect relative to the start of the expression */
+static int InvariantOp(ParseContext *c, Loop *loop, int addr, int *pDepth, int *pHandleDepth)
+{
+    uint8_t *p = c->codeBuf + addr;
+    IntrinsicInfo *info;
+
+    switch (*p) {
+    case OP_LREF2:
+        if (loop->localStored[p[2]])
+            return INV_NONE;
+        ++*pDepth;
+        /* fall through */
+    case OP_LREF:
+        if (loop->localStored[p[1]])
+            return INV_NONE;
+        /* fall through */
+    case OP_LIT:
+        ++*pDepth;
+        return INV_LOAD;
+    case OP_GREF:
+        if (GlobalStored(loop, p + 1))
+            return INV_NONE;
+        ++*pDepth;
+        return INV_LOAD;
+    case OP_LREFH:
+        if (loop->handleLocalStored[p[1]])
+            return INV_NONE;
+        /* fall through */
+    case OP_LITH:
+        ++*pHandleDepth;
+        return INV_LOAD;
+    case OP_GREFH:
+        if (GlobalStored(loop, p + 1))
+            return INV_NONE;
+        ++*pHandleDepth;
+        return INV_LOAD;
+    case OP_NOT:
+    case OP_NEG:
+    case OP_BNOT:
+    case OP_ADDI:
+        return *pDepth >= 1 ? INV_OP : INV_NONE;
+    case OP_ADD:
+    case OP_SUB:
+    case OP_MUL:
+    case OP_DIV:
+    case OP_REM:
+    case OP_BAND:
+    case OP_BOR:
+    case OP_BXOR:
+    case OP_SHL:
+    case OP_SHR:
+    case OP_LT:
+    case OP_LE:
+    case OP_EQ:
+    case OP_NE:
+    case OP_GE:
+    case OP_GT:
+        if (*pDepth < 2)
+            return INV_NONE;
+        --*pDepth;
+        return INV_OP;
+    case OP_CAT:
+        if (*pHandleDepth < 2)
+            return INV_NONE;
+        --*pHandleDepth;
+        return INV_STROP;
+    case OP_CATN:
+        if (*pHandleDepth < p[1])
+            return INV_NONE;
+        *pHandleDepth -= p[1] - 1;
+        return INV_STROP;
+    case OP_SCMP:
+        if (*pHandleDepth < 2)
+            return INV_NONE;
+        *pHandleDepth -= 2;
+        ++*pDepth;
+        return INV_STROP;
+    case OP_CALLI:
+        if (p[1] >= c->heap->nIntrinsics)
+            return INV_NONE;
+        info = &c->heap->intrinsicInfo[p[1]];
+        if (!(info->flags & INTRINSIC_PURE)
+        ||  *pDepth < info->argumentCount
+        ||  *pHandleDepth < info->handleArgumentCount)
+            return INV_NONE;
+        *pDepth -= info->argumentCount;
+        *pHandleDepth -= info->handleArgumentCount;
+        if (info->returnType == 'i')
+            ++*pDepth;
+        else if (info->returnType == 's')
+            ++*pHandleDepth;
+        return info->handleArgumentCount > 0 ? INV_STROP : INV_OP;
+    }
+    return INV_NONE;
+}
+
+/* MoveInvariants - compute the invariant expressions ahead of a loop and load their values in their place
+ *
+ * The first pass finds the new address of each instruction and the second
+ * moves them. A branch to the top of the loop from outside of it goes to the
+ * new code ahead of the loop and one from inside skips it.
+ */
+static void MoveInvariants(ParseContext *c, Loop *loop, Invariant *inv, int count)
+{
+    uint8_t *code = c->codeBuf, *out;
+    int size = (int)(c->cptr - c->codeBuf);
+    int *map, pass, addr, dst, body, len, target, n;
+    VMVALUE offset;
+
+    map = (int *)LocalAlloc(c, (size + 1) * sizeof(int));
+    out = (uint8_t *)LocalAlloc(c, size + count * (InstructionSize(OP_LSET) + InstructionSize(OP_LREF)));
+
+    body = dst = 0;
+    for (pass = 0; pass < 2; ++pass) {
+        for (addr = dst = FD_SIZE, n = 0; addr < size; ) {
+            map[addr] = dst;
+
+            /* compute the invariants ahead of the loop */
+            if (addr == loop->head) {
+                for (n = 0; n < count; ++n) {
+                    len = inv[n].end - inv[n].start;
+                    if (pass) {
+                        memcpy(out + dst, code + inv[n].start, len);
+                        out[dst + len] = inv[n].handle ? OP_LSETH : OP_LSET;
+                        out[dst + len + 1] = (uint8_t)inv[n].temp;
+                    }
+                    dst += len + InstructionSize(inv[n].handle ? OP_LSETH : OP_LSET);
+                }
+                body = dst;
+                n = 0;
+            }
+
+            /* load an invariant in place of the code computing it */
+            if (n < count && addr == inv[n].start) {
+                if (pass) {
+                    out[dst] = inv[n].handle ? OP_LREFH : OP_LREF;
+                    out[dst + 1] = (uint8_t)inv[n].temp;
+                }
+                dst += InstructionSize(inv[n].handle ? OP_LREFH : OP_LREF);
+                addr = inv[n++].end;
+            }
+
+            /* move any other instruction */
+            else {
+                len = InstructionSize(code[addr]);
+                if (pass) {
+                    memcpy(out + dst, code + addr, len);
+                    if (IsBranch(code[addr])) {
+                        target = BranchTarget(c, addr);
+                        if (target == loop->head && addr >= loop->head && addr < loop->end)
+                            target = body;
+                        else
+                            target = map[target];
+                        offset = target - (dst + len);
+                        memcpy(out + dst + len - sizeof(VMVALUE), &offset, sizeof(VMVALUE));
+                    }
+                }
+                dst += len;
+                addr += len;
+            }
+        }
+        map[size] = dst;
+    }
+
+    memcpy(code + FD_SIZE, out + FD_SIZE, dst - FD_SIZE);
+    c->cptr = code + dst;
+}
+
+/* IsBranch - check to see if an instruction ends with a branch offset */
+static int IsBranch(int op)
+{
+    switch (op) {
+    case OP_BRT:
+    case OP_BRTSC:
+    case OP_BRF:
+    case OP_BRFSC:
+    case OP_BR:
+    case OP_BRLT:
+    case OP_BRLE:
+    case OP_BREQ:
+    case OP_BRNE:
+    case OP_BRGE:
+    case OP_BRGT:
+    case OP_LBRLT:
+    case OP_LBRLE:
+    case OP_LBREQ:
+    case OP_LBRNE:
+    case OP_LBRGE:
+    case OP_LBRGT:
+    case OP_FORL:
+    case OP_NEXTL:
+    case OP_FORG:
+    case OP_NEXTG:
+        return VMTRUE;
+    }
+    return VMFALSE;
+}
+
+/* BranchTarget - get the address of the target of a branch instruction */
+static int BranchTarget(ParseContext *c, int addr)
+{
+    int end = addr + InstructionSize(c->codeBuf[addr]);
+    return end + rd_cword(c, end - sizeof(VMVALUE));
+}
+
+/* SetBranchTarget - set the address of the target of a branch instruction */
+static void SetBranchTarget(ParseContext *c, int addr, int target)
+{
+    int end = addr + InstructionSize(c->codeBuf[addr]);
+    wr_cword(c, end - sizeof(VMVALUE), target - end);
+}
+
+/* NextLive - get the address of the first instruction at or after an address that hasn't been deleted */
+static int NextLive(uint8_t *flags, int addr, int size)
+{
+    while (addr < size && (flags[addr] & (PH_START | PH_DEAD)) != PH_START)
+        ++addr;
+    return addr;
+}
+
+/* Delete - delete an instruction or the bytes following a shortened one */
+static void Delete(uint8_t *flags, int addr, int size)
+{
+    while (--size >= 0)
+        flags[addr++] |= PH_DEAD;
+}
+
+/* Compact - remove the deleted instructions and fix up the branch offsets */
+static int Compact(ParseContext *c, uint8_t *flags, int size)
+{
+    uint8_t *code = c->codeBuf;
+    int *map, addr, len, target, end;
+
+    /* find the new address of each instruction (a deleted one maps to the next one left) */
+    map = (int *)LocalAlloc(c, (size + 1) * sizeof(int));
+    for (addr = 0, end = 0; addr < size; ++addr)
+        if (addr < FD_SIZE || (flags[addr] & (PH_START | PH_DEAD)) == PH_START) {
+            map[addr] = end;
+            end += addr < FD_SIZE ? 1 : InstructionSize(code[addr]);
+        }
+    map[size] = end;
+    for (addr = size; --addr >= FD_SIZE; )
+        if ((flags[addr] & (PH_START | PH_DEAD)) != PH_START)
+            map[addr] = map[addr + 1];
+
+    /* move the instructions that are left */
+    for (addr = FD_SIZE; addr < size; ++addr)
+        if ((flags[addr] & (PH_START | PH_DEAD)) == PH_START) {
+            len = InstructionSize(code[addr]);
+            target = IsBranch(code[addr]) ? BranchTarget(c, addr) : -1;
+            memmove(code + map[addr], code + addr, len);
+            if (target >= 0)
+                wr_cword(c, map[addr] + len - sizeof(VMVALUE), map[target] - (map[addr] + len));
+        }
+
+    c->cptr = code + end;
+    return size - end;
+}
@@ -1,912 +1,1181 @@
-/* db_statement.c - statement parser
- *
- * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
- *
- */
-
-#include <stdlib.h>
-#include <string.h>
-#include "db_compiler.h"
-
-/* statement handler prototypes */
-static void ParseDef(ParseContext *c);
-static void ParseFunctionDef(ParseContext *c, int codeType);
-static void ParseEndFunction(ParseContext *c, int codeType);
-static void ParseDim(ParseContext *c);
-static int ParseVariableDecl(ParseContext *c, char *name, VMVALUE *pSize);
-static VMVALUE ParseScalarInitializer(ParseContext *c);
-static void ParseArrayInitializers(ParseContext *c, VMVALUE size);
-static void ClearArrayInitializers(ParseContext *c, VMVALUE size);
-static void ParseImpliedLetOrFunctionCall(ParseContext *c);
-static void ParseLet(ParseContext *c);
-static void ParseIf(ParseContext *c);
-static void ParseElse(ParseContext *c);
-static void ParseElseIf(ParseContext *c);
-static void ParseEndIf(ParseContext *c);
-static void ParseEnd(ParseContext *c);
-static void ParseFor(ParseContext *c);
-static void ParseNext(ParseContext *c);
-static void ParseDo(ParseContext *c);
-static void ParseDoWhile(ParseContext *c);
-static void ParseDoUntil(ParseContext *c);
-static void ParseLoop(ParseContext *c);
-static void ParseLoopWhile(ParseContext *c);
-static void ParseLoopUntil(ParseContext *c);
-static void ParseStop(ParseContext *c);
-static void ParseGoto(ParseContext *c);
-static void ParseReturn(ParseContext *c);
-static void ParsePrint(ParseContext *c);
-
-/* prototypes */
-static void CallHandler(ParseContext *c, char *name, ParseTreeNode *expr);
-static void DefineLabel(ParseContext *c, char *name, int offset);
-static int ReferenceLabel(ParseContext *c, char *name, int offset);
-static void PushBlock(ParseContext *c);
-static void PopBlock(ParseContext *c);
-
-/* ParseStatement - parse a statement */
-void ParseStatement(ParseContext *c, Token tkn)
-{
-    /* dispatch on the statement keyword */
-    switch (tkn) {
-    case T_REM:
-        /* just a comment so ignore the rest of the line */
-        break;
-    case T_DEF:
-        ParseDef(c);
-        break;
-    case T_FUNCTION:
-        ParseFunctionDef(c, CODE_TYPE_FUNCTION);
-        break;
-    case T_END_FUNCTION:
-        ParseEndFunction(c, CODE_TYPE_FUNCTION);
-        break;
-    case T_SUB:
-        ParseFunctionDef(c, CODE_TYPE_SUB);
-        break;
-    case T_END_SUB:
-        ParseEndFunction(c, CODE_TYPE_SUB);
-        break;
-    case T_DIM:
-        ParseDim(c);
-        break;
-    case T_LET:
-        ParseLet(c);
-        break;
-    case T_IF:
-        ParseIf(c);
-        break;
-    case T_ELSE:
-        ParseElse(c);
-        break;
-    case T_ELSE_IF:
-        ParseElseIf(c);
-        break;
-    case T_END_IF:
-        ParseEndIf(c);
-        break;
-    case T_END:
-        ParseEnd(c);
-        break;
-    case T_FOR:
-        ParseFor(c);
-        break;
-    case T_NEXT:
-        ParseNext(c);
-        break;
-    case T_DO:
-        ParseDo(c);
-        break;
-    case T_DO_WHILE:
-        ParseDoWhile(c);
-        break;
-    case T_DO_UNTIL:
-        ParseDoUntil(c);
-        break;
-    case T_LOOP:
-        ParseLoop(c);
-        break;
-    case T_LOOP_WHILE:
-        ParseLoopWhile(c);
-        break;
-    case T_LOOP_UNTIL:
-        ParseLoopUntil(c);
-        break;
-    case T_STOP:
-        ParseStop(c);
-        break;
-    case T_GOTO:
-        ParseGoto(c);
-        break;
-    case T_RETURN:
-        ParseReturn(c);
-        break;
-    case T_PRINT:
-        ParsePrint(c);
-        break;
-    case T_IDENTIFIER:
-        if (SkipSpaces(c) == ':') {
-            DefineLabel(c, c->token, codeaddr(c));
-            break;
-        }
-        UngetC(c);
-    default:
-        SaveToken(c, tkn);
-        ParseImpliedLetOrFunctionCall(c);
-        break;
-    }
-}
-
-/* ParseDef - parse the 'DEF' statement */
-static void ParseDef(ParseContext *c)
-{
-    char name[MAXTOKEN];
-    ParseTreeNode *expr;
-    VMHANDLE symbol;
-    Symbol *sym;
-
-    /* get the name being defined */
-    FRequire(c, T_IDENTIFIER);
-    strcpy(name, c->token);
-    FRequire(c, '=');
-
-    /* get the constant value */
-    expr = ParseExpr(c);
-
-    /* make sure it's a constant */
-    if (!IsIntegerLit(expr))
-        ParseError(c, "expecting a constant expression", NULL);
-
-    /* add the symbol as a global */
-    symbol = AddGlobal(c->heap, name, SC_CONSTANT, DefaultType(c, name));
-    sym = GetSymbolPtr(symbol);
-    sym->v.iValue = expr->u.integerLit.value;
-
-    FRequire(c, T_EOL);
-}
-
-/* ParseFunctionDef - parse a 'DEF <name> (' statement */
-static void ParseFunctionDef(ParseContext *c, int codeType)
-{
-    char name[MAXTOKEN];
-    VMHANDLE symbol, type, returnType;
-    Symbol *sym;
-    Token tkn;
-    Type *typ;
-
-    /* get the name being defined */
-    FRequire(c, T_IDENTIFIER);
-    strcpy(name, c->token);
-    
-    /* determine the return value type */
-    returnType = (codeType == CODE_TYPE_FUNCTION ? DefaultType(c, name) : NULL);
-    
-    /* make the function type */
-    type = NewType(c->heap, TYPE_FUNCTION);
-    typ = GetTypePtr(type);
-    typ->u.functionInfo.returnType = returnType;
-    InitSymbolTable(&c->arguments);
-    
-    /* enter the function name in the global symbol table */
-    symbol = AddGlobal(c->heap, name, SC_CONSTANT, type);
-    sym = GetSymbolPtr(symbol);
-
-    /* start the code under construction */
-    StartCode(c, sym->name, codeType, returnType);
-    sym->v.hValue = c->code;
-
-    /* get the argument list */
-    if ((tkn = GetToken(c)) == '(') {
-        if ((tkn = GetToken(c)) != ')') {
-            int offset = 0;
-            int handleOffset = 0;
-            SaveToken(c, tkn);
-            do {
-                VMHANDLE argType;
-                FRequire(c, T_IDENTIFIER);
-                argType = DefaultType(c, c->token);
-                if (IsHandleType(argType)) {
-                    AddLocal(c->heap, &c->arguments, c->token, argType, handleOffset);
-                    ++c->handleArgumentCount;
-                    --handleOffset;
-                }
-                else {
-                    AddLocal(c->heap, &c->arguments, c->token, argType, offset);
-                    ++c->argumentCount;
-                    ++offset;
-                }
-            } while ((tkn = GetToken(c)) == ',');
-            Require(c, tkn, ')');
-        }
-        tkn = GetToken(c);
-    }
-    
-    /* store the argument symbol table */
-    typ = GetTypePtr(type);
-    typ->u.functionInfo.arguments = c->arguments;
-    
-    Require(c, tkn, T_EOL);
-}
-
-/* ParseEndFunction - parse the 'END FUNCTION' and 'END SUB' statements */
-static void ParseEndFunction(ParseContext *c, int codeType)
-{
-    if (codeType != c->codeType) {
-        if (codeType == CODE_TYPE_FUNCTION)
-            ParseError(c, "not in FUNCTION definition", NULL);
-        else
-            ParseError(c, "not in SUB definition", NULL);
-    }
-    StoreCode(c);
-}
-
-/* ParseDim - parse the 'DIM' statement */
-static void ParseDim(ParseContext *c)
-{
-    char name[MAXTOKEN];
-    VMVALUE value, size;
-    int isArray;
-    Token tkn;
-
-    /* parse variable declarations */
-    do {
-
-        /* get variable name */
-        isArray = ParseVariableDecl(c, name, &size);
-
-        /* add to the global symbol table if outside a function definition */
-        if (c->codeType == CODE_TYPE_MAIN) {
-            VMHANDLE symbol;
-            Symbol *sym;
-
-            /* check for initializers */
-            if ((tkn = GetToken(c)) == '=') {
-                if (isArray)
-                    ParseArrayInitializers(c, size);
-                else
-                    value = ParseScalarInitializer(c);
-            }
-
-            /* no initializers */
-            else {
-                ClearArrayInitializers(c, size);
-                SaveToken(c, tkn);
-            }
-
-            /* add the symbol to the global symbol table */
-            symbol = AddGlobal(c->heap, name, SC_VARIABLE, DefaultType(c, name));
-            sym = GetSymbolPtr(symbol);
-
-            /* create a vector object for arrays */
-            if (isArray)
-                sym->v.hValue = StoreIntegerVector(c->heap, (VMVALUE *)c->codeBuf, size);
-            else
-                sym->v.iValue = value;
-        }
-
-        /* otherwise, add to the local symbol table */
-        else {
-            VMHANDLE type = DefaultType(c, name);
-            if (isArray)
-                ParseError(c, "local arrays are not supported", NULL);
-            if (IsHandleType(type)) {
-                AddLocal(c->heap, &c->locals, name, type, c->handleLocalOffset);
-                ++c->handleLocalOffset;
-            }
-            else {
-                AddLocal(c->heap, &c->locals, c->token, type, c->localOffset);
-                --c->localOffset;
-            }
-        }
-
-    } while ((tkn = GetToken(c)) == ',');
-
-    Require(c, tkn, T_EOL);
-}
-
-/* ParseVariableDecl - parse a variable declaration */
-static int ParseVariableDecl(ParseContext *c, char *name, VMVALUE *pSize)
-{
-    Token tkn;
-
-    /* parse the variable name */
-    FRequire(c, T_IDENTIFIER);
-    strcpy(name, c->token);
-
-    /* handle arrays */
-    if ((tkn = GetToken(c)) == '[') {
-        int size;
-
-        /* check for an array with unspecified size */
-        if ((tkn = GetToken(c)) == ']')
-            size = 0;
-
-        /* otherwise, parse the array size */
-        else {
-            ParseTreeNode *expr;
-
-            /* put back the token */
-            SaveToken(c, tkn);
-
-            /* get the array size */
-            expr = ParseExpr(c);
-
-            /* make sure it's a constant */
-            if (!IsIntegerLit(expr) || expr->u.integerLit.value <= 0)
-                ParseError(c, "expecting a positive constant expression", NULL);
-            size = expr->u.integerLit.value;
-
-            /* only one dimension allowed for now */
-            FRequire(c, ']');
-        }
-
-        /* return an array and its size */
-        *pSize = size;
-        return VMTRUE;
-    }
-
-    /* not an array */
-    else
-        SaveToken(c, tkn);
-
-    /* return a scalar */
-    return VMFALSE;
-}
-
-/* ParseScalarInitializer - parse a scalar initializer */
-static VMVALUE ParseScalarInitializer(ParseContext *c)
-{
-    ParseTreeNode *expr = ParseExpr(c);
-    if (!IsIntegerLit(expr))
-        ParseError(c, "expecting a constant expression", NULL);
-    return expr->u.integerLit.value;
-}
-
-/* ParseArrayInitializers - parse array initializers */
-static void ParseArrayInitializers(ParseContext *c, VMVALUE size)
-{
-    VMVALUE *dataPtr = (VMVALUE *)c->codeBuf;
-    VMVALUE *dataTop = (VMVALUE *)c->ctop;
-    int done = VMFALSE;
-    Token tkn;
-
-    FRequire(c, '{');
-
-    /* handle each line of initializers */
-    while (!done) {
-        int lineDone = VMFALSE;
-
-        /* look for the first non-blank line */
-        while ((tkn = GetToken(c)) == T_EOL) {
-            if (!GetLine(c->sys))
-                ParseError(c, "unexpected end of file in initializers", NULL);
-        }
-
-        /* check for the end of the initializers */
-        if (tkn == '}')
-            break;
-        SaveToken(c, tkn);
-
-        /* handle each initializer in the current line */
-        while (!lineDone) {
-            ParseTreeNode *expr;
-
-            /* get a constant expression */
-            expr = ParseExpr(c);
-            if (!IsIntegerLit(expr))
-                ParseError(c, "expecting a constant expression", NULL);
-
-            /* check for too many initializers */
-            if (--size < 0)
-                ParseError(c, "too many initializers", NULL);
-
-            /* store the initial value */
-            if (dataPtr >= dataTop)
-                ParseError(c, "insufficient object data space", NULL);
-            *dataPtr++ = expr->u.integerLit.value;
-
-            switch ((int)(tkn = GetToken(c))) {
-            case T_EOL:
-                lineDone = VMTRUE;
-                break;
-            case '}':
-                lineDone = VMTRUE;
-                done = VMTRUE;
-                break;
-            case ',':
-                break;
-            default:
-                ParseError(c, "expecting a comma, right brace or end of line", NULL);
-                break;
-            }
-
-        }
-    }
-}
-
-/* ClearArrayInitializers - clear the array initializers */
-static void ClearArrayInitializers(ParseContext *c, VMVALUE size)
-{
-    VMVALUE *dataPtr = (VMVALUE *)c->codeBuf;
-    VMVALUE *dataTop = (VMVALUE *)c->ctop;
-    if (dataPtr + size > dataTop)
-        ParseError(c, "insufficient object initializer space", NULL);
-    memset(dataPtr, 0, size * sizeof(VMVALUE));
-}
-
-/* ParseImpliedLetOrFunctionCall - parse an implied let statement or a function call */
-static void ParseImpliedLetOrFunctionCall(ParseContext *c)
-{
-    ParseTreeNode *expr;
-    Token tkn;
-    PVAL pv;
-    expr = ParsePrimary(c);
-    switch ((int)(tkn = GetToken(c))) {
-    case '=':
-        code_lvalue(c, expr, &pv);
-        ParseRValue(c);
-        (*pv.fcn)(c, PV_STORE, &pv);
-        break;
-    default:
-        SaveToken(c, tkn);
-        code_rvalue(c, expr);
-        putcbyte(c, OP_DROP);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-/* ParseLet - parse the 'LET' statement */
-static void ParseLet(ParseContext *c)
-{
-    ParseTreeNode *lvalue;
-    PVAL pv;
-    lvalue = ParsePrimary(c);
-    code_lvalue(c, lvalue, &pv);
-    FRequire(c, '=');
-    ParseRValue(c);
-    (*pv.fcn)(c, PV_STORE, &pv);
-    FRequire(c, T_EOL);
-}
-
-/* ParseIf - parse the 'IF' statement */
-static void ParseIf(ParseContext *c)
-{
-    Token tkn;
-    ParseRValue(c);
-    FRequire(c, T_THEN);
-    PushBlock(c);
-    c->bptr->type = BLOCK_IF;
-    putcbyte(c, OP_BRF);
-    c->bptr->u.IfBlock.nxt = putcword(c, 0);
-    c->bptr->u.IfBlock.end = 0;
-    if ((tkn = GetToken(c)) != T_EOL) {
-        ParseStatement(c, tkn);
-        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
-        PopBlock(c);
-    }
-    else
-        Require(c, tkn, T_EOL);
-}
-
-/* ParseElseIf - parse the 'ELSE IF' statement */
-static void ParseElseIf(ParseContext *c)
-{
-    switch (CurrentBlockType(c)) {
-    case BLOCK_IF:
-        putcbyte(c, OP_BR);
-        c->bptr->u.IfBlock.end = putcword(c, c->bptr->u.IfBlock.end);
-        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
-        c->bptr->u.IfBlock.nxt = 0;
-        ParseRValue(c);
-        FRequire(c, T_THEN);
-        putcbyte(c, OP_BRF);
-        c->bptr->u.IfBlock.nxt = putcword(c, 0);
-        FRequire(c, T_EOL);
-        break;
-    default:
-        ParseError(c, "ELSE IF without a matching IF", NULL);
-        break;
-    }
-}
-
-/* ParseElse - parse the 'ELSE' statement */
-static void ParseElse(ParseContext *c)
-{
-    int end;
-    switch (CurrentBlockType(c)) {
-    case BLOCK_IF:
-        putcbyte(c, OP_BR);
-        end = putcword(c, c->bptr->u.IfBlock.end);
-        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
-        c->bptr->type = BLOCK_ELSE;
-        c->bptr->u.ElseBlock.end = end;
-        break;
-    default:
-        ParseError(c, "ELSE without a matching IF", NULL);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-/* ParseEndIf - parse the 'END IF' statement */
-static void ParseEndIf(ParseContext *c)
-{
-    switch (CurrentBlockType(c)) {
-    case BLOCK_IF:
-        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
-        fixupbranch(c, c->bptr->u.IfBlock.end, codeaddr(c));
-        PopBlock(c);
-        break;
-    case BLOCK_ELSE:
-        fixupbranch(c, c->bptr->u.ElseBlock.end, codeaddr(c));
-        PopBlock(c);
-        break;
-    default:
-        ParseError(c, "END IF without a matching IF/ELSE IF/ELSE", NULL);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-
-/* ParseEnd - parse the 'END' statement */
-static void ParseEnd(ParseContext *c)
-{
-    putcbyte(c, OP_HALT);
-    FRequire(c, T_EOL);
-}
-
-/* ParseFor - parse the 'FOR' statement */
-static void ParseFor(ParseContext *c)
-{
-    ParseTreeNode *var, *step;
-    int test, body, inst;
-    Token tkn;
-    PVAL pv;
-
-    PushBlock(c);
-    c->bptr->type = BLOCK_FOR;
-
-    /* get the control variable */
-    FRequire(c, T_IDENTIFIER);
-    var = GetSymbolRef(c, c->token);
-    code_lvalue(c, var, &pv);
-    FRequire(c, '=');
-
-    /* parse the starting value expression */
-    ParseRValue(c);
-
-    /* parse the TO expression and generate the loop termination test */
-    test = codeaddr(c);
-    (*pv.fcn)(c, PV_STORE, &pv);
-    (*pv.fcn)(c, PV_LOAD, &pv);
-    FRequire(c, T_TO);
-    ParseRValue(c);
-    putcbyte(c, OP_LE);
-    putcbyte(c, OP_BRT);
-    body = putcword(c, 0);
-
-    /* branch to the end if the termination test fails */
-    putcbyte(c, OP_BR);
-    c->bptr->u.ForBlock.end = putcword(c, 0);
-
-    /* update the for variable after an iteration of the loop */
-    c->bptr->u.ForBlock.nxt = codeaddr(c);
-    (*pv.fcn)(c, PV_LOAD, &pv);
-
-    /* get the STEP expression */
-    if ((tkn = GetToken(c)) == T_STEP) {
-        step = ParseExpr(c);
-        code_rvalue(c, step);
-        tkn = GetToken(c);
-    }
-
-    /* no step so default to one */
-    else {
-        putcbyte(c, OP_LIT);
-        putcword(c, 1);
-    }
-
-    /* generate the increment code */
-    putcbyte(c, OP_ADD);
-    inst = putcbyte(c, OP_BR);
-    putcword(c, test - inst - 1 - sizeof(VMUVALUE));
-
-    /* branch to the loop body */
-    fixupbranch(c, body, codeaddr(c));
-    Require(c, tkn, T_EOL);
-}
-
-/* ParseNext - parse the 'NEXT' statement */
-static void ParseNext(ParseContext *c)
-{
-    //ParseTreeNode *var;
-    int inst;
-    switch (CurrentBlockType(c)) {
-    case BLOCK_FOR:
-        FRequire(c, T_IDENTIFIER);
-        //var = GetSymbolRef(c, c->token);
-        /* BUG: check to make sure it matches the symbol used in the FOR */
-        inst = putcbyte(c, OP_BR);
-        putcword(c, c->bptr->u.ForBlock.nxt - inst - 1 - sizeof(VMUVALUE));
-        fixupbranch(c, c->bptr->u.ForBlock.end, codeaddr(c));
-        PopBlock(c);
-        break;
-    default:
-        ParseError(c, "NEXT without a matching FOR", NULL);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-/* ParseDo - parse the 'DO' statement */
-static void ParseDo(ParseContext *c)
-{
-    PushBlock(c);
-    c->bptr->type = BLOCK_DO;
-    c->bptr->u.DoBlock.nxt = codeaddr(c);
-    c->bptr->u.DoBlock.end = 0;
-    FRequire(c, T_EOL);
-}
-
-/* ParseDoWhile - parse the 'DO WHILE' statement */
-static void ParseDoWhile(ParseContext *c)
-{
-    PushBlock(c);
-    c->bptr->type = BLOCK_DO;
-    c->bptr->u.DoBlock.nxt = codeaddr(c);
-    ParseRValue(c);
-    putcbyte(c, OP_BRF);
-    c->bptr->u.DoBlock.end = putcword(c, 0);
-    FRequire(c, T_EOL);
-}
-
-/* ParseDoUntil - parse the 'DO UNTIL' statement */
-static void ParseDoUntil(ParseContext *c)
-{
-    PushBlock(c);
-    c->bptr->type = BLOCK_DO;
-    c->bptr->u.DoBlock.nxt = codeaddr(c);
-    ParseRValue(c);
-    putcbyte(c, OP_BRT);
-    c->bptr->u.DoBlock.end = putcword(c, 0);
-    FRequire(c, T_EOL);
-}
-
-/* ParseLoop - parse the 'LOOP' statement */
-static void ParseLoop(ParseContext *c)
-{
-    int inst;
-    switch (CurrentBlockType(c)) {
-    case BLOCK_DO:
-        inst = putcbyte(c, OP_BR);
-        putcword(c, c->bptr->u.DoBlock.nxt - inst - 1 - sizeof(VMUVALUE));
-        fixupbranch(c, c->bptr->u.DoBlock.end, codeaddr(c));
-        PopBlock(c);
-        break;
-    default:
-        ParseError(c, "LOOP without a matching DO", NULL);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-/* ParseLoopWhile - parse the 'LOOP WHILE' statement */
-static void ParseLoopWhile(ParseContext *c)
-{
-    int inst;
-    switch (CurrentBlockType(c)) {
-    case BLOCK_DO:
-        ParseRValue(c);
-        inst = putcbyte(c, OP_BRT);
-        putcword(c, c->bptr->u.DoBlock.nxt - inst - 1 - sizeof(VMUVALUE));
-        fixupbranch(c, c->bptr->u.DoBlock.end, codeaddr(c));
-        PopBlock(c);
-        break;
-    default:
-        ParseError(c, "LOOP without a matching DO", NULL);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-/* ParseLoopUntil - parse the 'LOOP UNTIL' statement */
-static void ParseLoopUntil(ParseContext *c)
-{
-    int inst;
-    switch (CurrentBlockType(c)) {
-    case BLOCK_DO:
-        ParseRValue(c);
-        inst = putcbyte(c, OP_BRF);
-        putcword(c, c->bptr->u.DoBlock.nxt - inst - 1 - sizeof(VMUVALUE));
-        fixupbranch(c, c->bptr->u.DoBlock.end, codeaddr(c));
-        PopBlock(c);
-        break;
-    default:
-        ParseError(c, "LOOP without a matching DO", NULL);
-        break;
-    }
-    FRequire(c, T_EOL);
-}
-
-/* ParseStop - parse the 'STOP' statement */
-static void ParseStop(ParseContext *c)
-{
-    putcbyte(c, OP_HALT);
-    FRequire(c, T_EOL);
-}
-
-/* ParseGoto - parse the 'GOTO' statement */
-static void ParseGoto(ParseContext *c)
-{
-    FRequire(c, T_IDENTIFIER);
-    putcbyte(c, OP_BR);
-    putcword(c, ReferenceLabel(c, c->token, codeaddr(c)));
-    FRequire(c, T_EOL);
-}
-
-/* ParseReturn - parse the 'RETURN' statement */
-static void ParseReturn(ParseContext *c)
-{
-    Token tkn;
-    if (c->codeType == CODE_TYPE_MAIN)
-        ParseError(c, "return not allowed outside of a FUNCTION or SUB", NULL);
-    if ((tkn = GetToken(c)) == T_EOL) {
-        if (c->codeType == CODE_TYPE_FUNCTION)
-            ParseError(c, "expecting a return value", NULL);
-    }
-    else {
-        if (c->codeType == CODE_TYPE_SUB)
-            ParseError(c, "not expecting a return value", NULL);
-        SaveToken(c, tkn);
-        ParseRValue(c);
-        FRequire(c, T_EOL);
-    }
-    putcbyte(c, OP_BR);
-    c->returnFixups = putcword(c, c->returnFixups);
-}
-
-/* ParsePrint - handle the 'PRINT' statement */
-static void ParsePrint(ParseContext *c)
-{
-    int needNewline = VMTRUE;
-    ParseTreeNode *expr;
-    Token tkn;
-
-    while ((tkn = GetToken(c)) != T_EOL) {
-        switch ((int)tkn) {
-        case ',':
-            needNewline = VMFALSE;
-            CallHandler(c, "printTab", NULL);
-            break;
-        case ';':
-            needNewline = VMFALSE;
-            break;
-        default:
-            needNewline = VMTRUE;
-            SaveToken(c, tkn);
-            expr = ParseExpr(c);
-            if (expr->type == CommonType(c->heap, stringType))
-                CallHandler(c, "printStr", expr);
-            else
-                CallHandler(c, "printInt", expr);
-            break;
-        }
-    }
-
-    if (needNewline)
-        CallHandler(c, "printNL", NULL);
-    else
-        CallHandler(c, "printFlush", NULL);
-}
-
-/* CallHandler - compile a call to a runtime print function */
-static void CallHandler(ParseContext *c, char *name, ParseTreeNode *expr)
-{
-    VMHANDLE symbol;
-    Symbol *sym;
-    
-    /* find the built-in function */
-    if (!(symbol = FindGlobal(c->heap, name)))
-        ParseError(c, "undefined print function: %s", name);
-    sym = GetSymbolPtr(symbol);
-        
-    /* compile the argument */
-    if (expr)
-        code_rvalue(c, expr);
-    
-    /* compile the function symbol reference */
-    putcbyte(c, OP_LITH);
-    putcword(c, sym->v.iValue);
-
-    /* call the function */
-    putcbyte(c, OP_CALL);
-}
-
-/* DefineLabel - define a local label */
-static void DefineLabel(ParseContext *c, char *name, int offset)
-{
-    Label *label;
-
-    /* check to see if the label is already in the table */
-    for (label = c->labels; label != NULL; label = label->next)
-        if (strcasecmp(name, label->name) == 0) {
-            if (!label->fixups)
-                ParseError(c, "duplicate label", name);
-            else {
-                fixupbranch(c, label->fixups, offset);
-                label->offset = offset;
-                label->fixups = 0;
-            }
-            return;
-        }
-
-    /* allocate the label structure */
-    label = (Label *)LocalAlloc(c, sizeof(Label) + strlen(name));
-    memset(label, 0, sizeof(Label));
-    strcpy(label->name, name);
-    label->offset = offset;
-    label->next = c->labels;
-    c->labels = label;
-}
-
-/* ReferenceLabel - add a reference to a local label */
-static int ReferenceLabel(ParseContext *c, char *name, int offset)
-{
-    Label *label;
-
-    /* check to see if the label is already in the table */
-    for (label = c->labels; label != NULL; label = label->next)
-        if (strcasecmp(name, label->name) == 0) {
-            int link;
-            if (!(link = label->fixups))
-                return label->offset - offset - sizeof(VMUVALUE);
-            else {
-                label->fixups = offset;
-                return link;
-            }
-        }
-
-    /* allocate the label structure */
-    label = (Label *)LocalAlloc(c, sizeof(Label) + strlen(name));
-    memset(label, 0, sizeof(Label));
-    strcpy(label->name, name);
-    label->fixups = offset;
-    label->next = c->labels;
-    c->labels = label;
-
-    /* return zero to terminate the fixup list */
-    return 0;
-}
-
-/* CheckLabels - check for undefined labels */
-void CheckLabels(ParseContext *c)
-{
-    Label *label, *next;
-    for (label = c->labels; label != NULL; label = next) {
-        next = label->next;
-        if (label->fixups)
-            Abort(c->sys, "undefined label: %s", label->name);
-    }
-    c->labels = NULL;
-}
-
-/* CurrentBlockType - make sure there is a block on the stack */
-BlockType  CurrentBlockType(ParseContext *c)
-{
-    return c->bptr < c->blockBuf ? BLOCK_NONE : c->bptr->type;
-}
-
-/* PushBlock - push a block on the block stack */
-static void PushBlock(ParseContext *c)
-{
-    if (++c->bptr >= c->btop)
-        Abort(c->sys, "statements too deeply nested");
-}
-
-/* PopBlock - pop a block off the block stack */
-static void PopBlock(ParseContext *c)
-{
-    --c->bptr;
-}
+/* db_statement.c - statement parser
+ *
+ * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "db_compiler.h"
+
+/* statement handler prototypes */
+static void ParseDef(ParseContext *c);
+static void ParseFunctionDef(ParseContext *c, int codeType);
+static void ParseEndFunction(ParseContext *c, int codeType);
+static void ParseDim(ParseContext *c);
+static int ParseVariableDecl(ParseContext *c, char *name, VMVALUE *pSize);
+static VMVALUE ParseScalarInitializer(ParseContext *c);
+static void ParseArrayInitializers(ParseContext *c, VMVALUE size);
+static void ClearArrayInitializers(ParseContext *c, VMVALUE size);
+static VMVALUE *InitializerSpace(ParseContext *c);
+static void ParseImpliedLetOrFunctionCall(ParseContext *c);
+static void ParseLet(ParseContext *c);
+static void ParseIf(ParseContext *c);
+static void ParseElse(ParseContext *c);
+static void ParseElseIf(ParseContext *c);
+static void ParseEndIf(ParseContext *c);
+static void ParseEnd(ParseContext *c);
+static void ParseFor(ParseContext *c);
+static void ParseNext(ParseContext *c);
+static void ParseDo(ParseContext *c);
+static void ParseDoWhile(ParseContext *c);
+static void ParseDoUntil(ParseContext *c);
+static void ParseLoop(ParseContext *c);
+static void ParseLoopWhile(ParseContext *c);
+static void ParseLoopUntil(ParseContext *c);
+static void ParseStop(ParseContext *c);
+static void ParseGoto(ParseContext *c);
+static void ParseReturn(ParseContext *c);
+static void ParsePrint(ParseContext *c);
+
+/* prototypes */
+static void CallHandler(ParseContext *c, char *name, ParseTreeNode *expr);
+static void DefineLabel(ParseContext *c, char *name, int offset);
+static int ReferenceLabel(ParseContext *c, char *name, int offset);
+static void AddStatementCode(ParseContext *c, int start);
+static void PushBlock(ParseContext *c);
+static void PopBlock(ParseContext *c);
+static void SetForRange(ParseContext *c, VMVALUE start, VMVALUE limit, VMVALUE step);
+static void PutForGuard(ParseContext *c, VMVALUE size, int target);
+static void PutForBound(ParseContext *c, int var, int op, VMVALUE value, int target);
+static void FinishForGuard(ParseContext *c);
+static int ParseCondition(ParseContext *c, int branchIfTrue);
+
+/* ParseStatement - parse a statement */
+void ParseStatement(ParseContext *c, Token tkn)
+{
+    int start = codeaddr(c);
+
+    /* nothing is left on the stack between statements */
+    c->stackDepth = c->handleDepth = 0;
+
+    /* dispatch on the statement keyword */
+    switch (tkn) {
+    case T_REM:
+        /* just a comment so ignore the rest of the line */
+        break;
+    case T_DEF:
+        ParseDef(c);
+        break;
+    case T_FUNCTION:
+        ParseFunctionDef(c, CODE_TYPE_FUNCTION);
+        break;
+    case T_END_FUNCTION:
+        ParseEndFunction(c, CODE_TYPE_FUNCTION);
+        break;
+    case T_SUB:
+        ParseFunctionDef(c, CODE_TYPE_SUB);
+        break;
+    case T_END_SUB:
+        ParseEndFunction(c, CODE_TYPE_SUB);
+        break;
+    case T_DIM:
+        ParseDim(c);
+        break;
+    case T_LET:
+        ParseLet(c);
+        break;
+    case T_IF:
+        ParseIf(c);
+        break;
+    case T_ELSE:
+        ParseElse(c);
+        break;
+    case T_ELSE_IF:
+        ParseElseIf(c);
+        break;
+    case T_END_IF:
+        ParseEndIf(c);
+        break;
+    case T_END:
+        ParseEnd(c);
+        break;
+    case T_FOR:
+        ParseFor(c);
+        break;
+    case T_NEXT:
+        ParseNext(c);
+        break;
+    case T_DO:
+        ParseDo(c);
+        break;
+    case T_DO_WHILE:
+        ParseDoWhile(c);
+        break;
+    case T_DO_UNTIL:
+        ParseDoUntil(c);
+        break;
+    case T_LOOP:
+        ParseLoop(c);
+        break;
+    case T_LOOP_WHILE:
+        ParseLoopWhile(c);
+        break;
+    case T_LOOP_UNTIL:
+        ParseLoopUntil(c);
+        break;
+    case T_STOP:
+        ParseStop(c);
+        break;
+    case T_GOTO:
+        ParseGoto(c);
+        break;
+    case T_RETURN:
+        ParseReturn(c);
+        break;
+    case T_PRINT:
+        ParsePrint(c);
+        break;
+    case T_IDENTIFIER:
+        if (SkipSpaces(c) == ':') {
+            DefineLabel(c, c->token, codeaddr(c));
+            break;
+        }
+        UngetC(c);
+    default:
+        SaveToken(c, tkn);
+        ParseImpliedLetOrFunctionCall(c);
+        break;
+    }
+
+    /* remember the code in case it turns out to be unreachable (unless the statement already did) */
+    if (codeaddr(c) > start && (!c->statements || c->statements->start < start))
+        AddStatementCode(c, start);
+}
+
+/* ParseDef - parse the 'DEF' statement */
+static void ParseDef(ParseContext *c)
+{
+    char name[MAXTOKEN];
+    ParseTreeNode *expr;
+    VMHANDLE symbol;
+    Symbol *sym;
+
+    /* get the name being defined */
+    FRequire(c, T_IDENTIFIER);
+    strcpy(name, c->token);
+    FRequire(c, '=');
+
+    /* get the constant value */
+    expr = ParseExpr(c);
+
+    /* make sure it's a constant */
+    if (!IsIntegerLit(expr))
+        ParseError(c, "expecting a constant expression", NULL);
+
+    /* add the symbol as a global */
+    symbol = AddGlobal(c->heap, name, SC_CONSTANT, DefaultType(c, name));
+    sym = GetSymbolPtr(symbol);
+    sym->v.iValue = expr->u.integerLit.value;
+
+    FRequire(c, T_EOL);
+}
+
+/* ParseFunctionDef - parse a 'DEF <name> (' statement */
+static void ParseFunctionDef(ParseContext *c, int codeType)
+{
+    char name[MAXTOKEN];
+    VMHANDLE symbol, type, returnType;
+    Symbol *sym;
+    Token tkn;
+    Type *typ;
+
+    /* get the name being defined */
+    FRequire(c, T_IDENTIFIER);
+    strcpy(name, c->token);
+    
+    /* determine the return value type */
+    returnType = (codeType == CODE_TYPE_FUNCTION ? DefaultType(c, name) : NULL);
+    
+    /* make the function type */
+    type = NewType(c->heap, TYPE_FUNCTION);
+    typ = GetTypePtr(type);
+    typ->u.functionInfo.returnType = returnType;
+    InitSymbolTable(&c->arguments);
+    
+    /* enter the function name in the global symbol table */
+    symbol = AddGlobal(c->heap, name, SC_CONSTANT, type);
+    sym = GetSymbolPtr(symbol);
+
+    /* start the code under construction */
+    StartCode(c, sym->name, codeType, returnType);
+    sym->v.hValue = c->code;
+
+    /* get the argument list */
+    if ((tkn = GetToken(c)) == '(') {
+        if ((tkn = GetToken(c)) != ')') {
+            int offset = 0;
+            int handleOffset = 0;
+            SaveToken(c, tkn);
+            do {
+                VMHANDLE argType;
+                FRequire(c, T_IDENTIFIER);
+                argType = DefaultType(c, c->token);
+                if (IsHandleType(argType)) {
+                    AddLocal(c->heap, &c->arguments, c->token, argType, handleOffset);
+                    ++c->handleArgumentCount;
+                    --handleOffset;
+                }
+                else {
+                    AddLocal(c->heap, &c->arguments, c->token, argType, offset);
+                    ++c->argumentCount;
+                    ++offset;
+                }
+            } while ((tkn = GetToken(c)) == ',');
+            Require(c, tkn, ')');
+        }
+        tkn = GetToken(c);
+    }
+    
+    /* store the argument symbol table */
+    typ = GetTypePtr(type);
+    typ->u.functionInfo.arguments = c->arguments;
+    
+    Require(c, tkn, T_EOL);
+}
+
+/* ParseEndFunction - parse the 'END FUNCTION' and 'END SUB' statements */
+static void ParseEndFunction(ParseContext *c, int codeType)
+{
+    if (codeType != c->codeType) {
+        if (codeType == CODE_TYPE_FUNCTION)
+            ParseError(c, "not in FUNCTION definition", NULL);
+        else
+            ParseError(c, "not in SUB definition", NULL);
+    }
+    StoreCode(c);
+}
+
+/* ParseDim - parse the 'DIM' statement */
+static void ParseDim(ParseContext *c)
+{
+    char name[MAXTOKEN];
+    VMVALUE value, size;
+    int isArray;
+    Token tkn;
+
+    /* parse variable declarations */
+    do {
+
+        /* get variable name */
+        isArray = ParseVariableDecl(c, name, &size);
+
+        /* add to the global symbol table if outside a function definition */
+        if (c->codeType == CODE_TYPE_MAIN) {
+            VMHANDLE type = DefaultType(c, name);
+            int isStringArray = isArray && IsHandleType(type);
+            VMVALUE *initializers = NULL;
+            VMHANDLE symbol;
+            Symbol *sym;
+
+            /* check for initializers */
+            value = 0;
+            if ((tkn = GetToken(c)) == '=') {
+                if (isStringArray)
+                    ParseError(c, "string arrays can't have initializers", NULL);
+                else if (isArray) {
+                    ClearArrayInitializers(c, size);
+                    ParseArrayInitializers(c, size);
+                    initializers = InitializerSpace(c);
+                }
+                else
+                    value = ParseScalarInitializer(c);
+            }
+
+            /* no initializers */
+            else
+                SaveToken(c, tkn);
+
+            /* add the symbol to the global symbol table */
+            if (isStringArray)
+                type = CommonType(c->heap, stringArrayType);
+            else if (isArray)
+                type = CommonType(c->heap, integerArrayType);
+            symbol = AddGlobal(c->heap, name, SC_VARIABLE, type);
+            sym = GetSymbolPtr(symbol);
+
+            /* create a vector object for arrays (without initializers they start out zero or NULL) */
+            if (isArray) {
+                if (isStringArray)
+                    sym->v.hValue = StoreStringVector(c->heap, NULL, size);
+                else
+                    sym->v.hValue = StoreIntegerVector(c->heap, initializers, size);
+                if (!sym->v.hValue)
+                    ParseError(c, "insufficient memory for array", NULL);
+            }
+            else
+                sym->v.iValue = value;
+        }
+
+        /* otherwise, add to the local symbol table */
+        else {
+            VMHANDLE type = DefaultType(c, name);
+            if (isArray)
+                ParseError(c, "local arrays are not supported", NULL);
+            if (IsHandleType(type)) {
+                AddLocal(c->heap, &c->locals, name, type, c->handleLocalOffset);
+                ++c->handleLocalOffset;
+            }
+            else {
+                AddLocal(c->heap, &c->locals, c->token, type, c->localOffset);
+                --c->localOffset;
+            }
+        }
+
+    } while ((tkn = GetToken(c)) == ',');
+
+    Require(c, tkn, T_EOL);
+}
+
+/* ParseVariableDecl - parse a variable declaration */
+static int ParseVariableDecl(ParseContext *c, char *name, VMVALUE *pSize)
+{
+    Token tkn;
+
+    /* parse the variable name */
+    FRequire(c, T_IDENTIFIER);
+    strcpy(name, c->token);
+
+    /* handle arrays */
+    if ((tkn = GetToken(c)) == '[') {
+        int size;
+
+        /* check for an array with unspecified size */
+        if ((tkn = GetToken(c)) == ']')
+            size = 0;
+
+        /* otherwise, parse the array size */
+        else {
+            ParseTreeNode *expr;
+
+            /* put back the token */
+            SaveToken(c, tkn);
+
+            /* get the array size */
+            expr = ParseExpr(c);
+
+            /* make sure it's a constant */
+            if (!IsIntegerLit(expr) || expr->u.integerLit.value <= 0)
+                ParseError(c, "expecting a positive constant expression", NULL);
+            size = expr->u.integerLit.value;
+
+            /* only one dimension allowed for now */
+            FRequire(c, ']');
+        }
+
+        /* return an array and its size */
+        *pSize = size;
+        return VMTRUE;
+    }
+
+    /* not an array */
+    else
+        SaveToken(c, tkn);
+
+    /* return a scalar */
+    return VMFALSE;
+}
+
+/* ParseScalarInitializer - parse a scalar initializer */
+static VMVALUE ParseScalarInitializer(ParseContext *c)
+{
+    ParseTreeNode *expr = ParseExpr(c);
+    if (!IsIntegerLit(expr))
+        ParseError(c, "expecting a constant expression", NULL);
+    return expr->u.integerLit.value;
+}
+
+/* ParseArrayInitializers - parse array initializers */
+static void ParseArrayInitializers(ParseContext *c, VMVALUE size)
+{
+    VMVALUE *dataPtr = InitializerSpace(c);
+    VMVALUE *dataTop = (VMVALUE *)c->ctop;
+    int done = VMFALSE;
+    Token tkn;
+
+    FRequire(c, '{');
+
+    /* handle each line of initializers */
+    while (!done) {
+        int lineDone = VMFALSE;
+
+        /* look for the first non-blank line */
+        while ((tkn = GetToken(c)) == T_EOL) {
+            if (!GetLine(c->sys))
+                ParseError(c, "unexpected end of file in initializers", NULL);
+        }
+
+        /* check for the end of the initializers */
+        if (tkn == '}')
+            break;
+        SaveToken(c, tkn);
+
+        /* handle each initializer in the current line */
+        while (!lineDone) {
+            ParseTreeNode *expr;
+
+            /* get a constant expression */
+            expr = ParseExpr(c);
+            if (!IsIntegerLit(expr))
+                ParseError(c, "expecting a constant expression", NULL);
+
+            /* check for too many initializers */
+            if (--size < 0)
+                ParseError(c, "too many initializers", NULL);
+
+            /* store the initial value */
+            if (dataPtr >= dataTop)
+                ParseError(c, "insufficient object data space", NULL);
+            *dataPtr++ = expr->u.integerLit.value;
+
+            switch ((int)(tkn = GetToken(c))) {
+            case T_EOL:
+                lineDone = VMTRUE;
+                break;
+            case '}':
+                lineDone = VMTRUE;
+                done = VMTRUE;
+                break;
+            case ',':
+                break;
+            default:
+                ParseError(c, "expecting a comma, right brace or end of line", NULL);
+                break;
+            }
+
+        }
+    }
+}
+
+/* ClearArrayInitializers - clear the array initializers */
+static void ClearArrayInitializers(ParseContext *c, VMVALUE size)
+{
+    VMVALUE *dataPtr = InitializerSpace(c);
+    VMVALUE *dataTop = (VMVALUE *)c->ctop;
+    if (dataPtr + size > dataTop)
+        ParseError(c, "insufficient object initializer space", NULL);
+    memset(dataPtr, 0, size * sizeof(VMVALUE));
+}
+
+/* InitializerSpace - get the unused part of the code buffer to hold array initializers
+ *
+ * The main code under construction is at the start of the buffer so the
+ * initializers go after it.
+ */
+static VMVALUE *InitializerSpace(ParseContext *c)
+{
+    size_t offset = c->cptr - c->codeBuf;
+    offset = (offset + sizeof(VMVALUE) - 1) & ~(sizeof(VMVALUE) - 1);
+    return (VMVALUE *)(c->codeBuf + offset);
+}
+
+/* ParseImpliedLetOrFunctionCall - parse an implied let statement or a function call */
+static void ParseImpliedLetOrFunctionCall(ParseContext *c)
+{
+    ParseTreeNode *expr;
+    Token tkn;
+    expr = OptimizeExpr(c, ParsePrimary(c));
+    switch ((int)(tkn = GetToken(c))) {
+    case '=':
+        code_assignment(c, expr, ParseExpr(c));
+        break;
+    default:
+        SaveToken(c, tkn);
+        code_rvalue(c, expr);
+
+        /* a SUB leaves nothing to drop and a string result is on the handle stack */
+        if (expr->type) {
+            if (IsHandleType(expr->type)) {
+                putcbyte(c, OP_DROPH);
+                stackeffect(c, 0, -1);
+            }
+            else {
+                putcbyte(c, OP_DROP);
+                stackeffect(c, -1, 0);
+            }
+        }
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+/* ParseLet - parse the 'LET' statement */
+static void ParseLet(ParseContext *c)
+{
+    ParseTreeNode *lvalue;
+    lvalue = OptimizeExpr(c, ParsePrimary(c));
+    FRequire(c, '=');
+    code_assignment(c, lvalue, ParseExpr(c));
+    FRequire(c, T_EOL);
+}
+
+/* ParseIf - parse the 'IF' statement */
+static void ParseIf(ParseContext *c)
+{
+    Token tkn;
+    int nxt = ParseCondition(c, VMFALSE);
+    FRequire(c, T_THEN);
+    PushBlock(c);
+    c->bptr->type = BLOCK_IF;
+    c->bptr->u.IfBlock.nxt = nxt;
+    c->bptr->u.IfBlock.end = 0;
+    if ((tkn = GetToken(c)) != T_EOL) {
+        ParseStatement(c, tkn);
+        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
+        PopBlock(c);
+    }
+    else
+        Require(c, tkn, T_EOL);
+}
+
+/* ParseElseIf - parse the 'ELSE IF' statement */
+static void ParseElseIf(ParseContext *c)
+{
+    switch (CurrentBlockType(c)) {
+    case BLOCK_IF:
+        putcbyte(c, OP_BR);
+        c->bptr->u.IfBlock.end = putcword(c, c->bptr->u.IfBlock.end);
+        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
+        c->bptr->u.IfBlock.nxt = ParseCondition(c, VMFALSE);
+        FRequire(c, T_THEN);
+        FRequire(c, T_EOL);
+        break;
+    default:
+        ParseError(c, "ELSE IF without a matching IF", NULL);
+        break;
+    }
+}
+
+/* ParseElse - parse the 'ELSE' statement */
+static void ParseElse(ParseContext *c)
+{
+    int end;
+    switch (CurrentBlockType(c)) {
+    case BLOCK_IF:
+        putcbyte(c, OP_BR);
+        end = putcword(c, c->bptr->u.IfBlock.end);
+        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
+        c->bptr->type = BLOCK_ELSE;
+        c->bptr->u.ElseBlock.end = end;
+        break;
+    default:
+        ParseError(c, "ELSE without a matching IF", NULL);
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+/* ParseEndIf - parse the 'END IF' statement */
+static void ParseEndIf(ParseContext *c)
+{
+    switch (CurrentBlockType(c)) {
+    case BLOCK_IF:
+        fixupbranch(c, c->bptr->u.IfBlock.nxt, codeaddr(c));
+        fixupbranch(c, c->bptr->u.IfBlock.end, codeaddr(c));
+        PopBlock(c);
+        break;
+    case BLOCK_ELSE:
+        fixupbranch(c, c->bptr->u.ElseBlock.end, codeaddr(c));
+        PopBlock(c);
+        break;
+    default:
+        ParseError(c, "END IF without a matching IF/ELSE IF/ELSE", NULL);
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+
+/* ParseEnd - parse the 'END' statement */
+static void ParseEnd(ParseContext *c)
+{
+    putcbyte(c, OP_HALT);
+    FRequire(c, T_EOL);
+}
+
+/* ParseFor - parse the 'FOR' statement
+ *
+ * The limit and step are evaluated once and kept in a pair of hidden locals
+ * so that the FOR and NEXT instructions can do the loop tests and updates.
+ */
+static void ParseFor(ParseContext *c)
+{
+    ParseTreeNode *var, *start, *limit, *step;
+    Token tkn;
+    PVAL pv;
+
+    PushBlock(c);
+    c->bptr->type = BLOCK_FOR;
+    c->bptr->u.ForBlock.low = 0;
+    c->bptr->u.ForBlock.high = -1;
+    c->bptr->u.ForBlock.guard = 0;
+    c->bptr->u.ForBlock.guarded = VMFALSE;
+    c->bptr->u.ForBlock.array = NULL;
+    c->bptr->u.ForBlock.uncheckedCount = 0;
+
+    /* get the control variable */
+    FRequire(c, T_IDENTIFIER);
+    var = GetSymbolRef(c, c->token);
+    code_lvalue(c, var, &pv);
+    if (pv.fcn == code_local && !IsHandleType(GetLocalPtr(pv.u.hValue)->type)) {
+        c->bptr->u.ForBlock.op = OP_NEXTL;
+        c->bptr->u.ForBlock.var = GetLocalPtr(pv.u.hValue)->offset;
+    }
+    else if (pv.fcn == code_global && !IsHandleType(GetSymbolPtr(pv.u.hValue)->type)) {
+        c->bptr->u.ForBlock.op = OP_NEXTG;
+        c->bptr->u.ForBlock.var = (VMVALUE)HandleToValue(pv.u.hValue);
+    }
+    else
+        ParseError(c, "expecting a numeric variable", NULL);
+    FRequire(c, '=');
+
+    /* parse the starting value expression */
+    start = ParseExpr(c);
+    code_rvalue(c, start);
+    (*pv.fcn)(c, PV_STORE, &pv);
+
+    /* parse the TO expression */
+    FRequire(c, T_TO);
+    limit = ParseExpr(c);
+    code_rvalue(c, limit);
+
+    /* get the STEP expression */
+    if ((tkn = GetToken(c)) == T_STEP) {
+        step = ParseExpr(c);
+        code_rvalue(c, step);
+        tkn = GetToken(c);
+    }
+
+    /* no step so default to one */
+    else {
+        step = NULL;
+        putcbyte(c, OP_LIT);
+        putcword(c, 1);
+        stackeffect(c, 1, 0);
+    }
+    Require(c, tkn, T_EOL);
+
+    /* allocate the limit and step slots */
+    c->bptr->u.ForBlock.slot = c->localOffset;
+    c->localOffset -= 2;
+
+    /* store the limit and step and branch to the end if the loop doesn't run */
+    if (c->bptr->u.ForBlock.op == OP_NEXTL) {
+        putcbyte(c, OP_FORL);
+        putcbyte(c, c->bptr->u.ForBlock.var);
+    }
+    else {
+        putcbyte(c, OP_FORG);
+        putcword(c, c->bptr->u.ForBlock.var);
+    }
+    putcbyte(c, c->bptr->u.ForBlock.slot);
+    c->bptr->u.ForBlock.end = putcword(c, 0);
+
+    /* with a constant range the body can index arrays without checking */
+    if (IsIntegerLit(start) && IsIntegerLit(limit) && (!step || IsIntegerLit(step)))
+        SetForRange(c, start->u.integerLit.value, limit->u.integerLit.value, step ? step->u.integerLit.value : 1);
+
+    /* with just a constant step a check ahead of the body can do that at run time */
+    else if (!step || IsIntegerLit(step)) {
+        c->bptr->u.ForBlock.step = step ? step->u.integerLit.value : 1;
+        c->bptr->u.ForBlock.guard = codeaddr(c);
+        c->bptr->u.ForBlock.guarded = VMTRUE;
+        PutForGuard(c, 0, c->bptr->u.ForBlock.guard);
+    }
+
+    /* the loop body follows */
+    c->bptr->u.ForBlock.nxt = codeaddr(c);
+}
+
+/* SetForRange - set the range of values the control variable takes in the body of a FOR loop
+ *
+ * The range only holds while nothing else stores into the control variable
+ * (see uncheck in db_generate.c). Going past a limit near the largest
+ * integer could wrap around so those loops don't get a range.
+ */
+static void SetForRange(ParseContext *c, VMVALUE start, VMVALUE limit, VMVALUE step)
+{
+    VMVALUE low = step >= 0 ? start : limit;
+    VMVALUE high = step >= 0 ? limit : start;
+    if (low >= 0 && low <= high
+    &&  (step <= 0 || (VMUVALUE)high + (VMUVALUE)step <= ((VMUVALUE)~0 >> 1))) {
+        c->bptr->u.ForBlock.low = low;
+        c->bptr->u.ForBlock.high = high;
+    }
+}
+
+/* PutForGuard - put the run time range check of a FOR loop
+ *
+ * The check falls through to the body when the control variable stays
+ * between zero and size - 1 and otherwise branches to target. FORL and
+ * FORG have already skipped the loop if it doesn't run so only the start
+ * and the limit need checking. The code is the same size whatever size and
+ * target are so FinishForGuard can fill them in after the body.
+ */
+static void PutForGuard(ParseContext *c, VMVALUE size, int target)
+{
+    int descending = c->bptr->u.ForBlock.step < 0;
+    PutForBound(c, !descending, OP_LBRLT, 0, target);
+    PutForBound(c, descending, OP_LBRGE, size, target);
+}
+
+/* PutForBound - compare the control variable or the limit of a FOR loop with a constant and branch to target */
+static void PutForBound(ParseContext *c, int var, int op, VMVALUE value, int target)
+{
+    Block *b = c->bptr;
+    if (var && b->u.ForBlock.op == OP_NEXTG) {
+        putcbyte(c, OP_GREF);
+        putcword(c, b->u.ForBlock.var);
+        putcbyte(c, OP_LIT);
+        putcword(c, value);
+        putcbyte(c, OP_BRLT + op - OP_LBRLT);
+        stackeffect(c, 2, 0);
+        stackeffect(c, -2, 0);
+    }
+    else {
+        putcbyte(c, op);
+        putcbyte(c, var ? b->u.ForBlock.var : b->u.ForBlock.slot);
+        putcword(c, value);
+    }
+    putcword(c, target - codeaddr(c) - sizeof(VMUVALUE));
+}
+
+/* FinishForGuard - finish the run time range check of a FOR loop after its NEXT
+ *
+ * The unchecked vector opcodes in the body are only right when the check
+ * passes so it branches to a copy of the body and NEXT with the checked
+ * opcodes when it fails. The copy follows the loop and the body branches
+ * around it. Branches inside the body are relative so the copy works the
+ * same but a GOTO out of the body wouldn't (see ReferenceLabel). If the
+ * body didn't use any unchecked opcodes or the copy doesn't fit the check
+ * becomes branches to the next instruction that OptimizeCode deletes.
+ */
+static void FinishForGuard(ParseContext *c)
+{
+    Block *b = c->bptr, *outer;
+    int body = b->u.ForBlock.nxt;
+    int end = codeaddr(c);
+    int copy, addr, chn, n;
+    uint8_t *p;
+
+    /* give up on the check if it isn't needed or the copy won't fit */
+    if (b->u.ForBlock.uncheckedCount == 0 || c->cptr + 1 + sizeof(VMUVALUE) + (end - body) > c->ctop)
+        uncheck(c, b->u.ForBlock.op, b->u.ForBlock.var);
+    if (!b->u.ForBlock.guarded) {
+        for (addr = b->u.ForBlock.guard; addr < body; addr += 1 + sizeof(VMUVALUE)) {
+            c->codeBuf[addr] = OP_BR;
+            wr_cword(c, addr + 1, 0);
+        }
+        return;
+    }
+
+    /* only report unreachable code in the copy where it came from */
+    AddStatementCode(c, end - InstructionSize(b->u.ForBlock.op));
+
+    /* the body goes around the copy */
+    putcbyte(c, OP_BR);
+    b->u.ForBlock.end = putcword(c, b->u.ForBlock.end);
+
+    /* copy the body with the checked opcodes */
+    copy = codeaddr(c);
+    memcpy(c->cptr, c->codeBuf + body, end - body);
+    c->cptr += end - body;
+    for (n = 0; n < b->u.ForBlock.uncheckedCount; ++n) {
+        p = &c->codeBuf[b->u.ForBlock.unchecked[n] + copy - body];
+        *p = (*p == OP_VREFU ? OP_VREF : OP_VSET);
+    }
+
+    /* the enclosing loops have to know about their unchecked opcodes in the copy */
+    for (outer = b - 1; outer >= c->blockBuf; --outer) {
+        if (outer->type != BLOCK_FOR)
+            continue;
+        for (n = outer->u.ForBlock.uncheckedCount; --n >= 0; ) {
+            addr = outer->u.ForBlock.unchecked[n];
+            if (addr >= body && addr < end) {
+                if (outer->u.ForBlock.uncheckedCount < MAXUNCHECKED)
+                    outer->u.ForBlock.unchecked[outer->u.ForBlock.uncheckedCount++] = addr + copy - body;
+                else {
+                    p = &c->codeBuf[addr + copy - body];
+                    *p = (*p == OP_VREFU ? OP_VREF : OP_VSET);
+                }
+            }
+        }
+    }
+
+    /* and the RETURN statements in the copy have to be fixed up with the others */
+    for (chn = c->returnFixups; chn != 0; chn = rd_cword(c, chn))
+        if (chn >= body && chn < end) {
+            wr_cword(c, chn + copy - body, c->returnFixups);
+            c->returnFixups = chn + copy - body;
+        }
+
+    /* fill in the check now that the array and the copy are known */
+    end = codeaddr(c);
+    c->cptr = c->codeBuf + b->u.ForBlock.guard;
+    PutForGuard(c, (VMVALUE)GetHeapObjSize(GetSymbolPtr(b->u.ForBlock.array)->v.hValue), copy);
+    c->cptr = c->codeBuf + end;
+}
+
+/* ParseCondition - parse a condition and code a branch taken when it is true or false
+ *
+ * A constant condition either gets an unconditional branch or no code at all.
+ * Returns the address of the branch offset to link into a fixup chain or zero
+ * if the branch is never taken.
+ */
+static int ParseCondition(ParseContext *c, int branchIfTrue)
+{
+    ParseTreeNode *expr = ParseExpr(c);
+    if (IsIntegerLit(expr)) {
+        if ((expr->u.integerLit.value != 0) != branchIfTrue)
+            return 0;
+        putcbyte(c, OP_BR);
+    }
+    else {
+        code_rvalue(c, expr);
+        putcop(c, branchIfTrue ? OP_BRT : OP_BRF);
+    }
+    return putcword(c, 0);
+}
+
+/* ParseNext - parse the 'NEXT' statement */
+static void ParseNext(ParseContext *c)
+{
+    //ParseTreeNode *var;
+    switch (CurrentBlockType(c)) {
+    case BLOCK_FOR:
+        FRequire(c, T_IDENTIFIER);
+        //var = GetSymbolRef(c, c->token);
+        /* BUG: check to make sure it matches the symbol used in the FOR */
+        putcbyte(c, c->bptr->u.ForBlock.op);
+        if (c->bptr->u.ForBlock.op == OP_NEXTL)
+            putcbyte(c, c->bptr->u.ForBlock.var);
+        else
+            putcword(c, c->bptr->u.ForBlock.var);
+        putcbyte(c, c->bptr->u.ForBlock.slot);
+        putcword(c, c->bptr->u.ForBlock.nxt - codeaddr(c) - sizeof(VMUVALUE));
+        if (c->bptr->u.ForBlock.guard)
+            FinishForGuard(c);
+        fixupbranch(c, c->bptr->u.ForBlock.end, codeaddr(c));
+        PopBlock(c);
+        break;
+    default:
+        ParseError(c, "NEXT without a matching FOR", NULL);
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+/* ParseDo - parse the 'DO' statement */
+static void ParseDo(ParseContext *c)
+{
+    PushBlock(c);
+    c->bptr->type = BLOCK_DO;
+    c->bptr->u.DoBlock.nxt = codeaddr(c);
+    c->bptr->u.DoBlock.end = 0;
+    FRequire(c, T_EOL);
+}
+
+/* ParseDoWhile - parse the 'DO WHILE' statement */
+static void ParseDoWhile(ParseContext *c)
+{
+    PushBlock(c);
+    c->bptr->type = BLOCK_DO;
+    c->bptr->u.DoBlock.nxt = codeaddr(c);
+    c->bptr->u.DoBlock.end = ParseCondition(c, VMFALSE);
+    FRequire(c, T_EOL);
+}
+
+/* ParseDoUntil - parse the 'DO UNTIL' statement */
+static void ParseDoUntil(ParseContext *c)
+{
+    PushBlock(c);
+    c->bptr->type = BLOCK_DO;
+    c->bptr->u.DoBlock.nxt = codeaddr(c);
+    c->bptr->u.DoBlock.end = ParseCondition(c, VMTRUE);
+    FRequire(c, T_EOL);
+}
+
+/* ParseLoop - parse the 'LOOP' statement */
+static void ParseLoop(ParseContext *c)
+{
+    int inst;
+    switch (CurrentBlockType(c)) {
+    case BLOCK_DO:
+        inst = putcbyte(c, OP_BR);
+        putcword(c, c->bptr->u.DoBlock.nxt - inst - 1 - sizeof(VMUVALUE));
+        fixupbranch(c, c->bptr->u.DoBlock.end, codeaddr(c));
+        PopBlock(c);
+        break;
+    default:
+        ParseError(c, "LOOP without a matching DO", NULL);
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+/* ParseLoopWhile - parse the 'LOOP WHILE' statement */
+static void ParseLoopWhile(ParseContext *c)
+{
+    switch (CurrentBlockType(c)) {
+    case BLOCK_DO:
+        fixupbranch(c, ParseCondition(c, VMTRUE), c->bptr->u.DoBlock.nxt);
+        fixupbranch(c, c->bptr->u.DoBlock.end, codeaddr(c));
+        PopBlock(c);
+        break;
+    default:
+        ParseError(c, "LOOP without a matching DO", NULL);
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+/* ParseLoopUntil - parse the 'LOOP UNTIL' statement */
+static void ParseLoopUntil(ParseContext *c)
+{
+    switch (CurrentBlockType(c)) {
+    case BLOCK_DO:
+        fixupbranch(c, ParseCondition(c, VMFALSE), c->bptr->u.DoBlock.nxt);
+        fixupbranch(c, c->bptr->u.DoBlock.end, codeaddr(c));
+        PopBlock(c);
+        break;
+    default:
+        ParseError(c, "LOOP without a matching DO", NULL);
+        break;
+    }
+    FRequire(c, T_EOL);
+}
+
+/* ParseStop - parse the 'STOP' statement */
+static void ParseStop(ParseContext *c)
+{
+    putcbyte(c, OP_HALT);
+    FRequire(c, T_EOL);
+}
+
+/* ParseGoto - parse the 'GOTO' statement */
+static void ParseGoto(ParseContext *c)
+{
+    FRequire(c, T_IDENTIFIER);
+    putcbyte(c, OP_BR);
+    putcword(c, ReferenceLabel(c, c->token, codeaddr(c)));
+    FRequire(c, T_EOL);
+}
+
+/* ParseReturn - parse the 'RETURN' statement */
+static void ParseReturn(ParseContext *c)
+{
+    ParseTreeNode *expr;
+    Token tkn;
+    if (c->codeType == CODE_TYPE_MAIN)
+        ParseError(c, "return not allowed outside of a FUNCTION or SUB", NULL);
+    if ((tkn = GetToken(c)) == T_EOL) {
+        if (c->codeType == CODE_TYPE_FUNCTION)
+            ParseError(c, "expecting a return value", NULL);
+
+        /* a SUB called just before the RETURN can run in place of this one */
+        code_tailcall(c);
+    }
+    else {
+        if (c->codeType == CODE_TYPE_SUB)
+            ParseError(c, "not expecting a return value", NULL);
+        SaveToken(c, tkn);
+        expr = ParseExpr(c);
+        code_rvalue(c, expr);
+        FRequire(c, T_EOL);
+
+        /* RETURN f(...) runs f in place of this function if it returns the same kind of value */
+        if (expr->type && !IsHandleType(expr->type) == !IsHandleType(c->returnType) && code_tailcall(c))
+            return;
+    }
+    putcbyte(c, OP_BR);
+    c->returnFixups = putcword(c, c->returnFixups);
+}
+
+/* ParsePrint - handle the 'PRINT' statement */
+static void ParsePrint(ParseContext *c)
+{
+    int needNewline = VMTRUE;
+    ParseTreeNode *expr;
+    Token tkn;
+
+    while ((tkn = GetToken(c)) != T_EOL) {
+        switch ((int)tkn) {
+        case ',':
+            needNewline = VMFALSE;
+            CallHandler(c, "printTab", NULL);
+            break;
+        case ';':
+            needNewline = VMFALSE;
+            break;
+        default:
+            needNewline = VMTRUE;
+            SaveToken(c, tkn);
+            expr = ParseExpr(c);
+            if (expr->type == CommonType(c->heap, stringType))
+                CallHandler(c, "printStr", expr);
+            else
+                CallHandler(c, "printInt", expr);
+            break;
+        }
+    }
+
+    if (needNewline)
+        CallHandler(c, "printNL", NULL);
+    else
+        CallHandler(c, "printFlush", NULL);
+}
+
+/* CallHandler - compile a call to a runtime print function */
+static void CallHandler(ParseContext *c, char *name, ParseTreeNode *expr)
+{
+    VMHANDLE symbol;
+    Symbol *sym;
+    int index;
+    
+    /* find the built-in function */
+    if (!(symbol = FindGlobal(c->heap, name)))
+        ParseError(c, "undefined print function: %s", name);
+    sym = GetSymbolPtr(symbol);
+        
+    /* compile the argument */
+    if (expr)
+        code_rvalue(c, expr);
+    
+    /* call the function directly through the intrinsic table */
+    if ((index = IntrinsicIndex(c->heap, sym->v.hValue)) >= 0) {
+        putcbyte(c, OP_CALLI);
+        putcbyte(c, index);
+    }
+
+    /* otherwise, compile the function symbol reference and call it */
+    else {
+        putcbyte(c, OP_LITH);
+        putcword(c, sym->v.iValue);
+        stackeffect(c, 0, 1);
+        putcbyte(c, OP_CALL);
+        stackeffect(c, 0, -1);
+    }
+
+    /* the call consumes the argument */
+    if (expr && expr->type && IsHandleType(expr->type))
+        stackeffect(c, 0, -1);
+    else if (expr)
+        stackeffect(c, -1, 0);
+}
+
+/* DefineLabel - define a local label */
+static void DefineLabel(ParseContext *c, char *name, int offset)
+{
+    Label *label;
+
+    /* a GOTO into a loop could bring any value of its control variable */
+    uncheck(c, 0, 0);
+
+    /* check to see if the label is already in the table */
+    for (label = c->labels; label != NULL; label = label->next)
+        if (strcasecmp(name, label->name) == 0) {
+            if (!label->fixups)
+                ParseError(c, "duplicate label", name);
+            else {
+                fixupbranch(c, label->fixups, offset);
+                label->offset = offset;
+                label->fixups = 0;
+            }
+            return;
+        }
+
+    /* allocate the label structure */
+    label = (Label *)LocalAlloc(c, sizeof(Label) + strlen(name));
+    memset(label, 0, sizeof(Label));
+    strcpy(label->name, name);
+    label->offset = offset;
+    label->next = c->labels;
+    c->labels = label;
+}
+
+/* ReferenceLabel - add a reference to a local label */
+static int ReferenceLabel(ParseContext *c, char *name, int offset)
+{
+    Label *label;
+    Block *b;
+
+    /* a copy of a loop body can't have a branch out of it (see FinishForGuard) */
+    for (b = c->bptr; b >= c->blockBuf; --b)
+        if (b->type == BLOCK_FOR && b->u.ForBlock.guarded)
+            uncheck(c, b->u.ForBlock.op, b->u.ForBlock.var);
+
+    /* check to see if the label is already in the table */
+    for (label = c->labels; label != NULL; label = label->next)
+        if (strcasecmp(name, label->name) == 0) {
+            int link;
+            if (!(link = label->fixups))
+                return label->offset - offset - sizeof(VMUVALUE);
+            else {
+                label->fixups = offset;
+                return link;
+            }
+        }
+
+    /* allocate the label structure */
+    label = (Label *)LocalAlloc(c, sizeof(Label) + strlen(name));
+    memset(label, 0, sizeof(Label));
+    strcpy(label->name, name);
+    label->fixups = offset;
+    label->next = c->labels;
+    c->labels = label;
+
+    /* return zero to terminate the fixup list */
+    return 0;
+}
+
+/* CheckLabels - check for undefined labels */
+void CheckLabels(ParseContext *c)
+{
+    Label *label, *next;
+    for (label = c->labels; label != NULL; label = next) {
+        next = label->next;
+        if (label->fixups)
+            Abort(c->sys, "undefined label: %s", label->name);
+    }
+    c->labels = NULL;
+}
+
+/* AddStatementCode - add the code generated for a statement to the list */
+static void AddStatementCode(ParseContext *c, int start)
+{
+    StatementCode *stmt = (StatementCode *)LocalAlloc(c, sizeof(StatementCode));
+    stmt->lineNumber = c->sys->lineNumber;
+    stmt->start = start;
+    stmt->end = codeaddr(c);
+    stmt->next = c->statements;
+    c->statements = stmt;
+}
+
+/* CurrentBlockType - make sure there is a block on the stack */
+BlockType  CurrentBlockType(ParseContext *c)
+{
+    return c->bptr < c->blockBuf ? BLOCK_NONE : c->bptr->type;
+}
+
+/* PushBlock - push a block on the block stack */
+static void PushBlock(ParseContext *c)
+{
+    if (++c->bptr >= c->btop)
+        Abort(c->sys, "statements too deeply nested");
+}
+
+/* PopBlock - pop a block off the block stack */
+static void PopBlock(ParseContext *c)
+{
+    --c->bptr;
+}
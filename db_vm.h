@@ -1,119 +1,285 @@
-/* db_vm.h - definitions for a simple virtual machine
- *
- * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
- *
- */
-
-#ifndef __DB_VM_H__
-#define __DB_VM_H__
-
-#include <stdio.h>
-#include <stdarg.h>
-#include "db_types.h"
-#include "db_image.h"
-#include "db_system.h"
-
-/* forward type declarations */
-typedef struct Interpreter Interpreter;
-
-/* must be after the typedef for Interpreter */
-#include "db_vmheap.h"
-
-/* interpreter state structure */
-struct Interpreter {
-    System *sys;
-    ObjHeap *heap;                  /* heap */
-    VMVALUE *stack;
-    VMVALUE *stackTop;
-    VMVALUE *fp;
-    VMVALUE *sp;
-    VMHANDLE *hfp;
-    VMHANDLE *hsp;
-    VMHANDLE code;
-    uint8_t *cbase;
-    uint8_t *pc;
-};
-
-/* stack manipulation macros */
-#define Reserve(i, n)   do {                                            \
-                            if ((i)->sp - (n) <= (VMVALUE *)(i)->hsp)   \
-                                StackOverflow(i);                       \
-                            else  {                                     \
-                                int cnt = (n);                          \
-                                while (--cnt >= 0)                      \
-                                    Push(i, 0);                         \
-                            }                                           \
-                        } while (0)
-#define CPush(i, v)     do {                                            \
-                            if (--(i)->sp <= (VMVALUE *)(i)->hsp) {     \
-                                ++(i)->sp;                              \
-                                StackOverflow(i);                       \
-                            }                                           \
-                            else                                        \
-                                *(i)->sp = (v);                         \
-                        } while (0)
-#define Push(i, v)      (*--(i)->sp = (v))
-#define Pop(i)          (*(i)->sp++)
-#define Drop(i, n)      ((i)->sp += (n))
-
-#define ReserveH(i, n)  do {                                            \
-                            if ((i)->hsp + (n) >= (VMHANDLE *)(i)->sp)  \
-                                StackOverflow(i);                       \
-                            else  {                                     \
-                                int cnt = (n);                          \
-                                while (--cnt >= 0)                      \
-                                    PushH(i, NULL);                     \
-                            }                                           \
-                        } while (0)
-#define CPushH(i, v)    do {                                            \
-                            if (++(i)->hsp >= (VMHANDLE *)(i)->sp) {    \
-                                --(i)->hsp;                             \
-                                StackOverflow(i);                       \
-                            }                                           \
-                            else                                        \
-                                *(i)->hsp = (v);                        \
-                        } while (0)
-#define PushH(i, v)     (*++(i)->hsp = (v))
-#define PopH(i)         (*(i)->hsp--)
-#define DropH(i, n)     ((i)->hsp -= (n))
-
-/* prototypes */
-void StackOverflow(Interpreter *i);
-
-extern FLASH_SPACE char str_subscript_err[];
-extern FLASH_SPACE char str_stack_overflow_err[];
-extern FLASH_SPACE char str_not_code_object_err[];
-extern FLASH_SPACE char str_opcode_err[];
-extern FLASH_SPACE char str_value_fmt[];
-extern FLASH_SPACE char str_hfp_tag[];
-extern FLASH_SPACE char str_hstack_entry_fmt[];
-extern FLASH_SPACE char str_stack_separator[];
-extern FLASH_SPACE char str_fp_tag[];
-extern FLASH_SPACE char str_stack_entry[];
-
-/* prototypes from db_vmint.c */
-int Execute(System *sys, ObjHeap *heap, VMHANDLE main);
-
-/* prototypes from db_vmdebug.c */
-void DecodeFunction(VMUVALUE base, const uint8_t *code, int len);
-int DecodeInstruction(VMUVALUE base, const uint8_t *code, const uint8_t *lc);
-void ShowStack(Interpreter *i);
-
-/* directory entry structure (platform specific) */
-typedef struct VMDIRENT VMDIRENT;
-
-/* open directory structure (platform specific) */
-typedef struct VMDIR VMDIR;
-
-void VM_sysinit(int argc, char *argv[]);
-void VM_flush(void);
-int VM_opendir(const char *path, VMDIR *dir);
-int VM_readdir(VMDIR *dir, VMDIRENT *entry);
-void VM_closedir(VMDIR *dir);
-
-VMFILE *VM_fopen(const char *name, const char *mode);
-int VM_fclose(VMFILE *fp);
-char *VM_fgets(char *buf, int size, VMFILE *fp);
-int VM_fputs(const char *buf, VMFILE *fp);
-
-#endif
+/* db_vm.h - definitions for a simple virtual machine
+ *
+ * Copyright (c) 2009 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#ifndef __DB_VM_H__
+#define __DB_VM_H__
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "db_types.h"
+#include "db_image.h"
+#include "db_system.h"
+
+/* forward type declarations */
+typedef struct Interpreter Interpreter;
+
+#ifdef JIT
+
+/* native code for a function (see db_vmjit.c) */
+typedef void NativeCode(Interpreter *i);
+
+/* return address of a frame for a function called from native code */
+#define NATIVE_PC       -1
+
+/* tiered execution state of a code object
+ *
+ * Every function starts out interpreted. It is compiled to native code once
+ * it has been started callThreshold times or has taken loopThreshold
+ * backward branches. The offset map lets a hot loop carry on in native code.
+ */
+typedef struct {
+    NativeCode *native;             /* native code or NULL if interpreted */
+    VMVALUE *index;                 /* bytecode offset to native code offset */
+    VMVALUE calls;                  /* number of times the function was started */
+    VMVALUE backEdges;              /* number of backward branches taken */
+} CodeTier;
+
+/* reasons for compiling a function */
+#define TIER_CALLS      0
+#define TIER_LOOPS      1
+
+/* tiered execution statistics */
+typedef struct {
+    VMVALUE callThreshold;          /* calls before a function is compiled */
+    VMVALUE loopThreshold;          /* backward branches before a function is compiled */
+    VMVALUE promotedByCalls;        /* functions compiled because they were called often */
+    VMVALUE promotedByLoops;        /* functions compiled because of a hot loop */
+    VMVALUE rejected;               /* hot functions that couldn't be compiled */
+    VMVALUE loopEntries;            /* loops that carried on in native code */
+} TierStats;
+
+#endif
+
+/* must be after the typedef for Interpreter */
+#include "db_vmheap.h"
+
+#ifdef PREDECODE
+
+/* pre-decoded instruction
+ *
+ * When PREDECODE is defined Execute translates each code object into an array
+ * of these before running the program. Operands are decoded once rather than
+ * a byte at a time each time they are executed and branch operands hold the
+ * index of the target instruction. The compiler, the heap and image files
+ * still only deal with packed bytecode.
+ */
+typedef struct {
+    union {
+        int opcode;
+        void *handler;              /* handler address when DIRECT_THREADED */
+    } op;
+    VMVALUE operand;
+} Instr;
+
+typedef Instr VMCODE;
+
+#ifdef REGISTER_VM
+
+/* register instructions
+ *
+ * With REGISTER_VM defined each code object is translated into three address
+ * register code instead (see db_vmreg.c). These opcodes only appear in the
+ * translated code. Instructions that need the stack, like calls, are kept
+ * as they are. The register form of the arithmetic, logical and comparison
+ * operators is their stack opcode plus R_OP.
+ */
+#define R_OP            0x80    /* d = a op b or d = op a */
+#define R_NOT           (R_OP + OP_NOT)
+#define R_NEG           (R_OP + OP_NEG)
+#define R_ADD           (R_OP + OP_ADD)
+#define R_SUB           (R_OP + OP_SUB)
+#define R_MUL           (R_OP + OP_MUL)
+#define R_DIV           (R_OP + OP_DIV)
+#define R_REM           (R_OP + OP_REM)
+#define R_BNOT          (R_OP + OP_BNOT)
+#define R_BAND          (R_OP + OP_BAND)
+#define R_BOR           (R_OP + OP_BOR)
+#define R_BXOR          (R_OP + OP_BXOR)
+#define R_SHL           (R_OP + OP_SHL)
+#define R_SHR           (R_OP + OP_SHR)
+#define R_LT            (R_OP + OP_LT)
+#define R_LE            (R_OP + OP_LE)
+#define R_EQ            (R_OP + OP_EQ)
+#define R_NE            (R_OP + OP_NE)
+#define R_GE            (R_OP + OP_GE)
+#define R_GT            (R_OP + OP_GT)
+#define R_MOV           0xa0    /* d = a */
+#define R_LI            0xa1    /* d = literal too big for an immediate operand */
+#define R_BRT           0xa2    /* branch if a is true */
+#define R_BRF           0xa3    /* branch if a is false */
+#define R_BRLT          0xa4    /* branch if a is less than b */
+#define R_BRLE          0xa5    /* branch if a is less than or equal to b */
+#define R_BREQ          0xa6    /* branch if a is equal to b */
+#define R_BRNE          0xa7    /* branch if a is not equal to b */
+#define R_BRGE          0xa8    /* branch if a is greater than or equal to b */
+#define R_BRGT          0xa9    /* branch if a is greater than b */
+#define R_ADJSP         0xaa    /* move the stack pointer past the temporaries */
+
+/* register operands (the low two bits give the kind) */
+#define R_IMMEDIATE     0       /* literal value */
+#define R_LOCAL         1       /* frame slot offset from fp */
+#define R_TEMP          2       /* stack slot offset from sp */
+#define R_GLOBAL        3       /* global symbol handle */
+#define RegOperand(kind, n)     ((VMVALUE)(n) * 4 + (kind))
+#define GlobalOperand(h)        ((VMVALUE)(h) | R_GLOBAL)
+#define FitsImmediate(n)        ((n) >= -(1L << 29) && (n) < (1L << 29))
+
+/* room left below sp for the temporaries of the register code */
+#define STACK_SLACK     16
+
+#endif
+
+#else
+
+typedef uint8_t VMCODE;
+
+#endif
+
+/* interpreter state structure */
+struct Interpreter {
+    System *sys;
+    ObjHeap *heap;                  /* heap */
+    VMVALUE *stack;
+    VMVALUE *stackTop;
+    VMVALUE *fp;
+    VMHANDLE *hfp;
+    VMVALUE *sp;
+    VMHANDLE *hsp;
+    VMHANDLE code;
+    VMCODE *cbase;
+    VMCODE *pc;
+#ifdef PREDECODE
+    Instr **decoded;                /* pre-decoded code indexed by handle */
+    Instr *decodedBase;             /* start of the pre-decoded code */
+    Instr *decodedTop;              /* end of the pre-decoded code */
+#endif
+#ifdef JIT
+    CodeTier *tiers;                /* tier state indexed by handle */
+    VMVALUE callThreshold;          /* calls before a function is compiled */
+    VMVALUE loopThreshold;          /* backward branches before a function is compiled */
+#endif
+};
+
+#ifndef STACK_SLACK
+#define STACK_SLACK     0
+#endif
+
+/* stack manipulation macros */
+#define Reserve(i, n)   do {                                            \
+                            if ((i)->sp - (n) - STACK_SLACK <= (VMVALUE *)(i)->hsp) \
+                                StackOverflow(i);                       \
+                            else  {                                     \
+                                int cnt = (n);                          \
+                                while (--cnt >= 0)                      \
+                                    Push(i, 0);                         \
+                            }                                           \
+                        } while (0)
+#define CPush(i, v)     do {                                            \
+                            if (--(i)->sp - STACK_SLACK <= (VMVALUE *)(i)->hsp) { \
+                                ++(i)->sp;                              \
+                                StackOverflow(i);                       \
+                            }                                           \
+                            else                                        \
+                                *(i)->sp = (v);                         \
+                        } while (0)
+#define Push(i, v)      (*--(i)->sp = (v))
+#define Pop(i)          (*(i)->sp++)
+#define Drop(i, n)      ((i)->sp += (n))
+
+#define ReserveH(i, n)  do {                                            \
+                            if ((i)->hsp + (n) >= (VMHANDLE *)((i)->sp - STACK_SLACK)) \
+                                StackOverflow(i);                       \
+                            else  {                                     \
+                                int cnt = (n);                          \
+                                while (--cnt >= 0)                      \
+                                    PushH(i, NULL);                     \
+                            }                                           \
+                        } while (0)
+#define CPushH(i, v)    do {                                            \
+                            if (++(i)->hsp >= (VMHANDLE *)((i)->sp - STACK_SLACK)) { \
+                                --(i)->hsp;                             \
+                                StackOverflow(i);                       \
+                            }                                           \
+                            else                                        \
+                                *(i)->hsp = (v);                        \
+                        } while (0)
+#define PushH(i, v)     (*++(i)->hsp = (v))
+#define PopH(i)         (*(i)->hsp--)
+#define DropH(i, n)     ((i)->hsp -= (n))
+
+/* prototypes */
+void StackOverflow(Interpreter *i);
+
+extern FLASH_SPACE char str_subscript_err[];
+extern FLASH_SPACE char str_stack_overflow_err[];
+extern FLASH_SPACE char str_not_code_object_err[];
+extern FLASH_SPACE char str_opcode_err[];
+extern FLASH_SPACE char str_value_fmt[];
+extern FLASH_SPACE char str_hfp_tag[];
+extern FLASH_SPACE char str_hstack_entry_fmt[];
+extern FLASH_SPACE char str_stack_separator[];
+extern FLASH_SPACE char str_fp_tag[];
+extern FLASH_SPACE char str_stack_entry[];
+
+/* prototypes from db_vmint.c */
+int Execute(System *sys, ObjHeap *heap, VMHANDLE main);
+int InstructionSize(int opcode);
+void StringCat(Interpreter *i, int count);
+void StringCompare(Interpreter *i, int op);
+VMHANDLE StringAppend(Interpreter *i, VMHANDLE hStr);
+#ifdef PREDECODE
+Instr *DecodeInstr(Instr *ip, uint8_t *base, uint8_t *p, VMVALUE *index);
+#endif
+#ifdef JIT
+void CallFromNative(Interpreter *i);
+NativeCode *TailCallFromNative(Interpreter *i);
+void ReturnFromNative(Interpreter *i);
+#endif
+
+/* prototypes from db_vmreg.c */
+#ifdef REGISTER_VM
+Instr *TranslateCode(Interpreter *i, VMHANDLE code);
+#endif
+
+/* prototypes from db_vmjit.c */
+#ifdef JIT
+int InitTiers(Interpreter *i);
+NativeCode *CompileHotCode(Interpreter *i, VMHANDLE code, int reason);
+uint8_t *NativeLoopEntry(Interpreter *i, VMHANDLE code, VMVALUE offset);
+void EnterNative(Interpreter *i, uint8_t *entry);
+void SetTierThresholds(VMVALUE calls, VMVALUE loops);
+void ShowTierStats(void);
+#endif
+
+/* prototypes from db_vmverify.c */
+#ifdef UNCHECKED
+char *VerifyCode(ObjHeap *heap, VMHANDLE code, uint8_t *scratch, uint8_t *scratchTop, int *pOffset);
+#endif
+
+/* prototypes from db_vmdebug.c */
+void DecodeFunction(VMUVALUE base, const uint8_t *code, int len);
+int DecodeInstruction(VMUVALUE base, const uint8_t *code, const uint8_t *lc);
+void ShowStack(Interpreter *i);
+
+/* directory entry structure (platform specific) */
+typedef struct VMDIRENT VMDIRENT;
+
+/* open directory structure (platform specific) */
+typedef struct VMDIR VMDIR;
+
+void VM_sysinit(int argc, char *argv[]);
+void VM_flush(void);
+VMUVALUE VM_ticks(void);
+int VM_opendir(const char *path, VMDIR *dir);
+int VM_readdir(VMDIR *dir, VMDIRENT *entry);
+void VM_closedir(VMDIR *dir);
+
+VMFILE *VM_fopen(const char *name, const char *mode);
+int VM_fclose(VMFILE *fp);
+char *VM_fgets(char *buf, int size, VMFILE *fp);
+int VM_fputs(const char *buf, VMFILE *fp);
+
+#endif
@@ -1,853 +1,1242 @@
-/* db_vmheap.c - simple heap manager
- *
- * Copyright (c) 2012 by David Michael Betz.  All rights reserved.
- *
- */
-
-#include <string.h>
-#include "db_vm.h"
-#include "db_image.h"
-#include "db_vmdebug.h"
-
-/* round to multiple of the word size */
-#define WORDMASK        (sizeof(VMVALUE) - 1)
-#define WORDSIZE(n)     (((n) + WORDMASK) & ~WORDMASK)
-
-/* element sizes */
-static size_t elementSizes[] = {
-    sizeof(VMVALUE),            /* ObjTypeIntegerVector */
-    sizeof(VMHANDLE),           /* ObjTypeStringVector */
-    sizeof(uint8_t),            /* ObjTypeByteVector */
-    sizeof(uint8_t),            /* ObjTypeSymbol */
-    sizeof(uint8_t),            /* ObjTypeArgument */
-    sizeof(uint8_t),            /* ObjTypeType */
-    sizeof(uint8_t),            /* ObjTypeString */
-    sizeof(uint8_t),            /* ObjTypeCode */
-    sizeof(IntrinsicHandler *)  /* ObjTypeIntrinsic */
-};
-
-/* type names */
-static char *typeNames[] = {
-    "IntegerVector",
-    "StringVector",
-    "ByteVector",
-    "Symbol",
-    "Local",
-    "Type",
-    "String",
-    "Code",
-    "Intrinsic"
-};
-
-DefIntrinsic(abs);
-DefIntrinsic(rnd);
-DefIntrinsic(left);
-DefIntrinsic(right);
-DefIntrinsic(mid);
-DefIntrinsic(chr);
-DefIntrinsic(str);
-DefIntrinsic(val);
-DefIntrinsic(asc);
-DefIntrinsic(len);
-DefIntrinsic(printStr);
-DefIntrinsic(printInt);
-DefIntrinsic(printTab);
-DefIntrinsic(printNL);
-DefIntrinsic(printFlush);
-
-/* local functions */
-static void ObjRelease1(ObjHeap *heap, VMHANDLE stack);
-static VMHANDLE DereferenceAndMaybePushObject(VMHANDLE stack, VMHANDLE object);
-static VMHANDLE TraceCode(VMHANDLE stack, uint8_t *code, size_t size);
-
-/* InitHeap - initialize a heap */
-ObjHeap *InitHeap(System *sys, size_t size, int nHandles)
-{
-    size_t overheadSize, dataSize;
-    ObjHeap *heap;
-    uint8_t *data;
-    
-    /* get the size of the header plus the handle table */
-    overheadSize = sizeof(ObjHeap) + nHandles * sizeof(void *);
-     
-    /* make sure there is enough space left for object data */
-    if (size <= overheadSize)
-        longjmp(sys->errorTarget, 1);
-    dataSize = size - overheadSize;
-
-    /* allocate and initialize the parse context */
-    if (!(data = (uint8_t *)AllocateFreeSpace(sys, size)))
-        longjmp(sys->errorTarget, 1);
-    heap = (ObjHeap *)data;
-    heap->sys = sys;
-    
-    /* setup the heap header */
-    data += sizeof(ObjHeap);
-
-    /* setup the handle array */
-    heap->handles = (VMHANDLE)(data + dataSize);
-    heap->endHandles = heap->handles + nHandles;
-    heap->nHandles = nHandles;
-    heap->data = data;
-    
-    /* initialize the heap */
-    ResetHeap(heap);
-    
-    /* return the new heap */
-    return heap;
-}
-
-/* ResetHeap - reset the heap to its intial state */
-void ResetHeap(ObjHeap *heap)
-{
-    VMHANDLE handle;
-    int cnt;
-    
-    /* create the handle free list */
-    heap->freeHandles = NULL;
-    for (handle = heap->handles, cnt = heap->nHandles; --cnt >= 0; ++handle) {
-        *handle = (void *)heap->freeHandles;
-        heap->freeHandles = handle;
-    }
-
-    /* setup the heap free space */
-    heap->free = heap->data;
-    
-    /* initialize the global symbol table */
-    InitSymbolTable(&heap->globals);
-
-    /* initialize the common types */
-    InitCommonType(heap, integerType, TYPE_INTEGER);
-    InitCommonType(heap, integerArrayType, TYPE_ARRAY);
-    heap->integerArrayType.type.u.arrayInfo.elementType = CommonType(heap, integerType);
-    InitCommonType(heap, byteType, TYPE_BYTE);
-    InitCommonType(heap, byteArrayType, TYPE_ARRAY);
-    heap->byteArrayType.type.u.arrayInfo.elementType = CommonType(heap, byteType);
-    InitCommonType(heap, stringType,TYPE_STRING);
-    InitCommonType(heap, stringArrayType, TYPE_ARRAY);
-    heap->stringArrayType.type.u.arrayInfo.elementType = CommonType(heap, stringType);
-
-    /* add the intrinsic functions */
-    AddIntrinsic(heap, "ABS",          abs,        "i=i")
-    AddIntrinsic(heap, "RND",          rnd,        "i=i")
-    AddIntrinsic(heap, "LEFT$",        left,       "s=si")
-    AddIntrinsic(heap, "RIGHT$",       right,      "s=si")
-    AddIntrinsic(heap, "MID$",         mid,        "s=sii")
-    AddIntrinsic(heap, "CHR$",         chr,        "s=i")
-    AddIntrinsic(heap, "STR$",         str,        "s=i")
-    AddIntrinsic(heap, "VAL",          val,        "i=s")
-    AddIntrinsic(heap, "ASC",          asc,        "i=s")
-    AddIntrinsic(heap, "LEN",          len,        "i=s")
-    AddIntrinsic(heap, "printStr",     printStr,   "=s")
-    AddIntrinsic(heap, "printInt",     printInt,   "=i")
-    AddIntrinsic(heap, "printTab",     printTab,   "=")
-    AddIntrinsic(heap, "printNL",      printNL,    "=")
-    AddIntrinsic(heap, "printFlush",   printFlush, "=")
-}
-
-/* InitSymbolTable - initialize a symbol table */
-void InitSymbolTable(SymbolTable *table)
-{
-    table->head = NULL;
-    table->tail = NULL;
-    table->count = 0;
-}
-
-/* AddGlobal - add a global symbol to the symbol table */
-VMHANDLE AddGlobal(ObjHeap *heap, const char *name, StorageClass storageClass, VMHANDLE type)
-{
-    VMHANDLE symbol;
-    
-    /* allocate the symbol object */
-    if (!(symbol = NewSymbol(heap, name, storageClass, type)))
-        return NULL;
-        
-    /* add it to the symbol table */
-    if (heap->globals.tail == NULL)
-        heap->globals.head = heap->globals.tail = symbol;
-    else {
-        Symbol *last = GetSymbolPtr(heap->globals.tail);
-        heap->globals.tail = symbol;
-        last->next = symbol;
-    }
-    ++heap->globals.count;
-    
-    /* return the symbol */
-    return symbol;
-}
-
-/* FindGlobal - find a symbol in the global symbol table */
-VMHANDLE FindGlobal(ObjHeap *heap, const char *name)
-{
-    VMHANDLE symbol = heap->globals.head;
-    while (symbol) {
-        Symbol *sym = GetSymbolPtr(symbol);
-        if (strcasecmp(name, sym->name) == 0)
-            return symbol;
-        symbol = sym->next;
-    }
-    return NULL;
-}
-
-/* DumpGlobals - dump the global symbol table */
-void DumpGlobals(ObjHeap *heap)
-{
-    VMHANDLE symbol = heap->globals.head;
-    if (symbol) {
-        VM_printf("Globals:\n");
-        while (symbol) {
-            Symbol *sym = GetSymbolPtr(symbol);
-            VM_printf("  %s %04x\n", sym->name, sym->v.iValue);
-            symbol = sym->next;
-        }
-    }
-}
-
-/* AddLocal - add a symbol to a local symbol table */
-VMHANDLE AddLocal(ObjHeap *heap, SymbolTable *table, const char *name, VMHANDLE type, VMVALUE offset)
-{
-    VMHANDLE local;
-    
-    /* allocate the local symbol object */
-    if (!(local = NewLocal(heap, name, type, offset)))
-        return NULL;
-        
-    /* add it to the symbol table */
-    if (table->tail == NULL)
-        table->head = table->tail = local;
-    else {
-        Local *last = GetLocalPtr(table->tail);
-        table->tail = local;
-        last->next = local;
-    }
-    ++table->count;
-    
-    /* return the symbol */
-    return local;
-}
-
-/* FindLocal - find a local symbol in a symbol table */
-VMHANDLE FindLocal(SymbolTable *table, const char *name)
-{
-    VMHANDLE local = table->head;
-    while (local) {
-        Local *sym = GetLocalPtr(local);
-        if (strcasecmp(name, sym->name) == 0)
-            return local;
-        local = sym->next;
-    }
-    return NULL;
-}
-
-/* DumpLocals - dump a local symbol table */
-void DumpLocals(SymbolTable *table, const char *tag)
-{
-    VMHANDLE symbol;
-    if ((symbol = table->head) != NULL) {
-        VM_printf("%s:\n", tag);
-        while (symbol) {
-            Local *sym = GetLocalPtr(symbol);
-            VM_printf("  %s %d\n", sym->name, sym->offset);
-            symbol = sym->next;
-        }
-    }
-}
-
-/* AddIntrinsic1 - add an intrinsic function to the global symbol table */
-void AddIntrinsic1(ObjHeap *heap, char *name, char *types, VMHANDLE handler)
-{
-    int argumentCount, handleArgumentCount;
-    VMHANDLE symbol, type, argType;
-    SymbolTable arguments;
-    Type *typ;
-    
-    /* make the function type */
-    if (!(type = NewType(heap, TYPE_FUNCTION)))
-        longjmp(heap->sys->errorTarget, 1);
-    typ = GetTypePtr(type);
-    InitSymbolTable(&arguments);
-    
-    /* set the return type */
-    switch (*types++) {
-    case 'i':
-        typ->u.functionInfo.returnType = CommonType(heap, integerType);
-        break;
-    case 's':
-        typ->u.functionInfo.returnType = CommonType(heap, stringType);
-        break;
-    case '=':
-        typ->u.functionInfo.returnType = NULL;
-        goto argumentTypes;
-    default:
-        longjmp(heap->sys->errorTarget, 1);
-    }
-    
-argumentTypes:
-    /* initialize the argument counts */
-    argumentCount = handleArgumentCount = 0;
-    
-    /* add the argument types */
-    if (*types++ == '=') {
-        while (*types) {
-            switch (*types++) {
-            case 'i':
-                argType = CommonType(heap, integerType);
-                ++argumentCount;
-                break;
-            case 's':
-                argType = CommonType(heap, stringType);
-                ++handleArgumentCount;
-                break;
-            default:
-                longjmp(heap->sys->errorTarget, 1);
-            }
-            AddLocal(heap, &arguments, "", argType, 0);
-        }
-    }
-
-    /* add a global symbol for the intrinsic function */
-    if (!(symbol = AddGlobal(heap, name, SC_CONSTANT, type)))
-        longjmp(heap->sys->errorTarget, 1);
-    GetSymbolPtr(symbol)->v.hValue = handler;
-
-    /* store the argument symbol table */
-    typ = GetTypePtr(type);
-    typ->u.functionInfo.arguments = arguments;
-}
-
-/* NewSymbol - create a new symbol object */
-VMHANDLE NewSymbol(ObjHeap *heap, const char *name, StorageClass storageClass, VMHANDLE type)
-{
-    size_t size = sizeof(Symbol) + strlen(name);
-    VMHANDLE object;
-    Symbol *sym;
-    
-    /* allocate a symbol object */
-    if (!(object = ObjAlloc(heap, ObjTypeSymbol, size)))
-        return NULL;
-        
-    /* initialze the symbol */
-    sym = GetSymbolPtr(object);
-    memset(sym, 0, sizeof(Symbol));
-    strcpy(sym->name, name);
-    sym->storageClass = storageClass;
-    sym->type = type;
-
-    /* return the object */
-    return object;
-}
-
-/* NewLocal - create a new local symbol object */
-VMHANDLE NewLocal(ObjHeap *heap, const char *name, VMHANDLE type, VMVALUE offset)
-{
-    size_t size = sizeof(Local) + strlen(name);
-    VMHANDLE object;
-    Local *sym;
-    
-    /* allocate an argument object */
-    if (!(object = ObjAlloc(heap, ObjTypeLocal, size)))
-        return NULL;
-        
-    /* initialze the argument */
-    sym = GetLocalPtr(object);
-    memset(sym, 0, sizeof(Local));
-    strcpy(sym->name, name);
-    sym->type = type;
-    sym->offset = offset;
-
-    /* return the object */
-    return object;
-}
-
-/* NewType - create a new type object */
-VMHANDLE NewType(ObjHeap *heap, TypeID id)
-{
-    VMHANDLE object;
-    Type *type;
-    
-    /* allocate a type object */
-    if (!(object = ObjAlloc(heap, ObjTypeType, sizeof(Type))))
-        return NULL;
-        
-    /* initialze the type */
-    type = (Type *)GetHeapObjPtr(object);
-    memset(type, 0, sizeof(Type));
-    type->id = id;
-
-    /* return the object */
-    return object;
-}
-
-/* IsHandleType - check to see if a type is a heap object */
-int IsHandleType(VMHANDLE type)
-{
-    switch (GetTypePtr(type)->id) {
-    case TYPE_STRING:
-    case TYPE_ARRAY:
-    case TYPE_FUNCTION:
-        return VMTRUE;
-    default:
-        return VMFALSE;
-    }
-}
-
-/* NewCode - create a new code object */
-VMHANDLE NewCode(ObjHeap *heap, size_t size)
-{
-    return ObjAlloc(heap, ObjTypeCode, size);
-}
-
-/* NewString - create a new string object */
-VMHANDLE NewString(ObjHeap *heap, size_t size)
-{
-    return ObjAlloc(heap, ObjTypeString, size);
-}
-
-/* StoreIntegerVector - store an integer vector object */
-VMHANDLE StoreIntegerVector(ObjHeap *heap, const VMVALUE *buf, size_t size)
-{
-    VMHANDLE object;
-    VMVALUE *p;
-
-    /* allocate an integer vector object */
-    if (!(object = ObjAlloc(heap, ObjTypeIntegerVector, size)))
-        return NULL;
-    
-    /* copy the data into the vector object */
-    p = GetIntegerVectorBase(object);
-    while (size > 0) {
-        *p++ = *buf++;
-        --size;
-    }
-    
-    /* return the object */
-    return object;
-}
-
-/* StoreStringVector - store a string vector object */
-VMHANDLE StoreStringVector(ObjHeap *heap, const VMHANDLE *buf, size_t size)
-{
-    VMHANDLE object;
-    VMHANDLE *p;
-
-    /* allocate a string vector object */
-    if (!(object = ObjAlloc(heap, ObjTypeStringVector, size)))
-        return NULL;
-    
-    /* copy the data into the vector object */
-    p = GetStringVectorBase(object);
-    while (size > 0) {
-        *p++ = *buf++;
-        --size;
-    }
-    
-    /* return the object */
-    return object;
-}
-
-/* StoreByteVector - store a byte vector object */
-VMHANDLE StoreByteVector(ObjHeap *heap, ObjType type, const uint8_t *buf, size_t size)
-{
-    VMHANDLE object;
-    uint8_t *p;
-
-    /* allocate byte vector object */
-    if (!(object = ObjAlloc(heap, type, size)))
-        return NULL;
-    
-    /* copy the data into the byte vector object */
-    p = GetByteVectorBase(object);
-    while (size > 0) {
-        *p++ = *buf++;
-        --size;
-    }
-    
-    /* return the object */
-    return object;
-}
-
-/* StoreByteVectorData - store data for a previously allocated byte vector object */
-int StoreByteVectorData(ObjHeap *heap, VMHANDLE object, const uint8_t *buf, size_t size)
-{
-    uint8_t *p;
-
-    /* allocate byte vector object */
-    if (!ObjRealloc(heap, object, size))
-        return VMFALSE;
-    
-    /* copy the data into the byte vector object */
-    p = GetByteVectorBase(object);
-    while (size > 0) {
-        *p++ = *buf++;
-        --size;
-    }
-    
-    /* return the object */
-    return VMTRUE;
-}
-
-/* ObjAlloc - allocate a new object */
-VMHANDLE ObjAlloc(ObjHeap *heap, ObjType type, size_t size)
-{
-    size_t byteSize = size * elementSizes[type];
-    size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
-    VMHANDLE handle;
-    ObjHdr *hdr;
-
-    /* find a free handle */
-    if (!(handle = heap->freeHandles))
-        return NULL;
-
-    /* remove the handle from the free list */
-    heap->freeHandles = (VMHANDLE)*handle;
-
-    /* make sure there's enough space */
-    if ((uint8_t *)heap->handles - heap->free < totalSize) {
-        CompactHeap(heap);
-        if ((uint8_t *)heap->handles - heap->free < totalSize) {
-            *handle = (void *)heap->freeHandles;
-            heap->freeHandles = handle;
-            return NULL;
-        }
-    }
-
-    /* allocate the next available block */
-    hdr = (ObjHdr *)heap->free;
-    heap->free += totalSize;
-    
-    /* store the backpointer and length */
-    hdr->handle = handle;
-    hdr->type = type;
-    hdr->size = size;
-    hdr->refCnt = 1;
-    
-    /* store the pointer from the handle to the heap data */
-    *handle = (void *)(hdr + 1);
-
-    /* return successfully */
-    return handle;
-}
-
-/* ObjRealloc - reallocate space for an object */
-int ObjRealloc(ObjHeap *heap, VMHANDLE handle, size_t size)
-{
-    ObjHdr *hdr = GetHeapObjHdr(handle);
-    size_t byteSize = size * elementSizes[hdr->type];
-    size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
-    VMUVALUE refCnt;
-    ObjType type;
-
-    /* make sure there's enough space */
-    if ((uint8_t *)heap->handles - heap->free < totalSize) {
-        CompactHeap(heap);
-        if ((uint8_t *)heap->handles - heap->free < totalSize)
-            return VMFALSE;
-    }
-    
-    /* get the old type and reference count and free the old data space */
-    type = hdr->type;
-    refCnt = hdr->refCnt;
-    hdr->handle = NULL;
-
-    /* allocate the new space */
-    hdr = (ObjHdr *)heap->free;
-    heap->free += totalSize;
-    
-    /* store the backpointer and length */
-    hdr->handle = handle;
-    hdr->type = type;
-    hdr->size = size;
-    hdr->refCnt = refCnt;
-    
-    /* store the pointer from the handle to the heap data */
-    *handle = (void *)(hdr + 1);
-
-    /* return successfully */
-    return VMTRUE;
-}
-
-/* ObjRelease - release a reference to an object */
-void ObjRelease(ObjHeap *heap, VMHANDLE object)
-{
-    ObjRelease1(heap, DereferenceAndMaybePushObject(NULL, object));
-}
-
-/* ReleaseCode - release references in a block of code */
-void ReleaseCode(ObjHeap *heap, uint8_t *code, size_t size)
-{
-    ObjRelease1(heap, TraceCode(NULL, code, size));
-}
-    
-/* ObjRelease1 - release a reference to an object */
-static void ObjRelease1(ObjHeap *heap, VMHANDLE stack)
-{
-    VMHANDLE object;
-    
-    /* trace objects until the stack is empty */
-    while ((object = stack) != NULL) {
-        ObjHdr *hdr = GetHeapObjHdr(object);
-        
-        /* pop the stack */
-        stack = hdr->handle;
-    
-        /* free the object */
-        hdr->handle = NULL;
-        *object = (void *)heap->freeHandles;
-        heap->freeHandles = object;
-        
-        /* push any embedded object references */
-        switch (hdr->type) {
-        case ObjTypeStringVector:
-        {
-            VMHANDLE *base = GetStringVectorBase(object);
-            size_t i;
-            for (i = 0; i < hdr->size; ++i)
-                stack = DereferenceAndMaybePushObject(stack, base[i]);
-            break;
-        }
-        case ObjTypeSymbol:
-        {
-            Symbol *symbol = GetSymbolPtr(object);
-            stack = DereferenceAndMaybePushObject(stack, symbol->next);
-            stack = DereferenceAndMaybePushObject(stack, symbol->type);
-            if (IsHandleType(symbol->type))
-                stack = DereferenceAndMaybePushObject(stack, symbol->v.hValue);
-            break;
-        }
-        case ObjTypeLocal:
-        {
-            Local *local = GetLocalPtr(object);
-            stack = DereferenceAndMaybePushObject(stack, local->next);
-            stack = DereferenceAndMaybePushObject(stack, local->type);
-            break;
-        }
-        case ObjTypeType:
-        {
-            Type *type = GetTypePtr(object);
-            switch (type->id) {
-            case TYPE_ARRAY:
-                stack = DereferenceAndMaybePushObject(stack, type->u.arrayInfo.elementType);
-                break;
-            case TYPE_FUNCTION:
-                stack = DereferenceAndMaybePushObject(stack, type->u.functionInfo.returnType);
-                stack = DereferenceAndMaybePushObject(stack, type->u.functionInfo.arguments.head);
-                break;
-            default:
-                /* no internal references */
-                break;
-            }
-            break;
-        }
-        case ObjTypeCode:
-            stack = TraceCode(stack, GetCodePtr(object), hdr->size);
-            break;
-        default:    /* no internal references */
-            /* should never get here */
-            break;
-        }
-    }
-}
-
-/* DereferenceAndMaybePushObject - dereference an object and push it onto the trace stack if refCnt goes to zero */
-static VMHANDLE DereferenceAndMaybePushObject(VMHANDLE stack, VMHANDLE object)
-{
-    if (object != NULL) {
-        ObjHdr *hdr = GetHeapObjHdr(object);
-        if (hdr->handle && --hdr->refCnt == 0) {
-            hdr->handle = stack;
-            stack = object;
-        }
-    }
-    return stack;
-}
-
-/* TraceCode - trace object references in a code object */
-static VMHANDLE TraceCode(VMHANDLE stack, uint8_t *code, size_t size)
-{
-    uint8_t *p = code;
-    uint8_t *end = p + size;
-    while (p < end) {
-        switch (*p++) {
-        case OP_HALT:
-            break;
-        case OP_BRT:
-        case OP_BRTSC:
-        case OP_BRF:
-        case OP_BRFSC:
-        case OP_BR:
-            p += sizeof(VMVALUE);
-            break;
-        case OP_NOT:
-        case OP_NEG:
-        case OP_ADD:
-        case OP_SUB:
-        case OP_MUL:
-        case OP_DIV:
-        case OP_REM:
-        case OP_BNOT:
-        case OP_BAND:
-        case OP_BOR:
-        case OP_BXOR:
-        case OP_SHL:
-        case OP_SHR:
-        case OP_LT:
-        case OP_LE:
-        case OP_EQ:
-        case OP_NE:
-        case OP_GE:
-        case OP_GT:
-            break;
-        case OP_LIT:
-            p += sizeof(VMVALUE);
-            break;
-        case OP_LREF:
-        case OP_LSET:
-        case OP_LREFH:
-        case OP_LSETH:
-            p += 1;
-            break;
-        case OP_VREF:
-        case OP_VSET:
-        case OP_VREFH:
-        case OP_VSETH:
-            break;
-        case OP_RESERVE:
-        case OP_RETURN:
-            p += 2;
-        case OP_CALL:
-        case OP_DROP:
-            break;
-        case OP_LITH:
-        case OP_GREF:
-        case OP_GSET:
-        case OP_GREFH:
-        case OP_GSETH:
-        {
-            VMVALUE tmp;
-            get_VMVALUE(tmp, *p++);
-            stack = DereferenceAndMaybePushObject(stack, (VMHANDLE)tmp);
-            break;
-        }
-        case OP_CAT:
-            break;
-        default:
-            /* should never reach */
-            break;
-        }
-    }
-    
-    return stack;
-}
-
-/* CompactHeap - compact the heap */
-void CompactHeap(ObjHeap *heap)
-{
-    uint8_t *data, *next, *free;
-    
-    /* call the client's before function */
-    if (heap->beforeCompact)
-        (*heap->beforeCompact)(heap->compactCookie);
-
-    /* initialize the heap scan */
-    data = next = heap->data;
-    free = heap->free;
-
-    /* compact the heap */
-    while (data < free) {
-        ObjHdr *hdr = (ObjHdr *)data;
-        size_t byteSize = hdr->size * elementSizes[hdr->type];
-        size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
-        if (hdr->handle) {
-            if (data != next) {
-                VM_printf("Moving %p to %p\n", data, next);
-                *hdr->handle = (void *)(next + sizeof(ObjHdr));
-                memmove(next, data, totalSize);
-            }
-            next += totalSize;
-        }
-        data += totalSize;
-    }
-
-    /* store the new free pointer */
-    heap->free = next;
-
-    /* call the client's before function */
-    if (heap->afterCompact)
-        (*heap->afterCompact)(heap->compactCookie);
-}
-
-/* DumpHeap - dump the heap */
-void DumpHeap(ObjHeap *heap)
-{
-    uint8_t *data, *free;
-
-    /* initialize the heap scan */
-    data = heap->data;
-    free = heap->free;
-
-    /* compact the heap */
-    while (data < free) {
-        ObjHdr *hdr = (ObjHdr *)data;
-        size_t byteSize = hdr->size * elementSizes[hdr->type];
-        size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
-        VM_printf("%p h: %p, c: %d, t: %s, s: %d\n",
-                  hdr,
-                  hdr->handle,
-                  hdr->refCnt,
-                  typeNames[hdr->type],
-                  hdr->size);
-        if (hdr->handle) {
-            switch (hdr->type) {
-            case ObjTypeIntegerVector:
-                break;
-            case ObjTypeStringVector:
-                break;
-            case ObjTypeByteVector:
-                break;
-            case ObjTypeSymbol:
-            {
-                Symbol *sym = GetSymbolPtr(hdr->handle);
-                char *p = sym->name;
-                VM_printf("    ");
-                while (*p) 
-                    VM_putchar(*p++);
-                VM_putchar('\n');
-                break;
-            }
-            case ObjTypeLocal:
-            {
-                Local *sym = GetLocalPtr(hdr->handle);
-                char *p = sym->name;
-                VM_printf("    ");
-                while (*p) 
-                    VM_putchar(*p++);
-                VM_putchar('\n');
-                break;
-            }
-            case ObjTypeType:
-                break;
-            case ObjTypeString:
-            {
-                size_t cnt = hdr->size;
-                uint8_t *p = GetStringPtr(hdr->handle);
-                VM_printf("    \"");
-                while (cnt > 0) {
-                    VM_putchar(*p++);
-                    --cnt;
-                }
-                VM_printf("\"\n");
-                break;
-            }
-            case ObjTypeCode:
-            {
-                uint8_t *code = GetCodePtr(hdr->handle);
-                DecodeFunction((VMUVALUE)code, code, hdr->size);
-                break;
-            }
-            default:
-                break;
-            }
-        }
-        data += totalSize;
-    }
-}
+/* db_vmheap.c - simple heap manager
+ *
+ * Copyright (c) 2012 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#include <string.h>
+#include "db_vm.h"
+#include "db_image.h"
+#include "db_vmdebug.h"
+
+/* round to multiple of the word size */
+#define WORDMASK        (sizeof(VMVALUE) - 1)
+#define WORDSIZE(n)     (((n) + WORDMASK) & ~WORDMASK)
+
+/* size of the heap block holding an object */
+#define BlockSize(hdr)  (sizeof(ObjHdr) + WORDSIZE((hdr)->size * elementSizes[(hdr)->type]))
+
+/* element sizes */
+static size_t elementSizes[] = {
+    sizeof(VMVALUE),            /* ObjTypeIntegerVector */
+    sizeof(VMHANDLE),           /* ObjTypeStringVector */
+    sizeof(uint8_t),            /* ObjTypeByteVector */
+    sizeof(uint8_t),            /* ObjTypeSymbol */
+    sizeof(uint8_t),            /* ObjTypeArgument */
+    sizeof(uint8_t),            /* ObjTypeType */
+    sizeof(uint8_t),            /* ObjTypeString */
+    sizeof(uint8_t),            /* ObjTypeCode */
+    sizeof(IntrinsicHandler *), /* ObjTypeIntrinsic */
+    sizeof(uint8_t)             /* ObjTypeStringSlice */
+};
+
+/* type names */
+static char *typeNames[] = {
+    "IntegerVector",
+    "StringVector",
+    "ByteVector",
+    "Symbol",
+    "Local",
+    "Type",
+    "String",
+    "Code",
+    "Intrinsic",
+    "StringSlice"
+};
+
+DefIntrinsic(abs);
+DefIntrinsic(rnd);
+DefIntrinsic(left);
+DefIntrinsic(right);
+DefIntrinsic(mid);
+DefIntrinsic(chr);
+DefIntrinsic(str);
+DefIntrinsic(val);
+DefIntrinsic(asc);
+DefIntrinsic(len);
+DefIntrinsic(printStr);
+DefIntrinsic(printInt);
+DefIntrinsic(printTab);
+DefIntrinsic(printNL);
+DefIntrinsic(printFlush);
+DefIntrinsic(gcstats);
+DefIntrinsic(codestats);
+#ifdef JIT
+DefIntrinsic(tiers);
+DefIntrinsic(settiers);
+#endif
+
+/* local functions */
+static void ObjRelease1(ObjHeap *heap, VMHANDLE stack);
+static VMHANDLE DereferenceAndMaybePushObject(VMHANDLE stack, VMHANDLE object);
+static VMHANDLE TraceCode(VMHANDLE stack, uint8_t *code, size_t size);
+static void MakeFreeBlock(uint8_t *data, uint8_t *end);
+static void AddFreeBlock(ObjHeap *heap, ObjHdr *hdr);
+static ObjHdr *TakeFreeBlock(ObjHeap *heap, size_t totalSize);
+static ObjHdr *TakeFreeBlock1(ObjHeap *heap, int index, size_t totalSize);
+static void RecordPause(ObjHeap *heap, VMUVALUE ticks);
+
+/* InitHeap - initialize a heap */
+ObjHeap *InitHeap(System *sys, size_t size, int nHandles)
+{
+    size_t overheadSize, dataSize;
+    ObjHeap *heap;
+    uint8_t *data;
+    
+    /* get the size of the header plus the handle table */
+    overheadSize = sizeof(ObjHeap) + nHandles * sizeof(void *);
+     
+    /* make sure there is enough space left for object data */
+    if (size <= overheadSize)
+        longjmp(sys->errorTarget, 1);
+    dataSize = size - overheadSize;
+
+    /* allocate and initialize the parse context */
+    if (!(data = (uint8_t *)AllocateFreeSpace(sys, size)))
+        longjmp(sys->errorTarget, 1);
+    heap = (ObjHeap *)data;
+    heap->sys = sys;
+    
+    /* setup the heap header */
+    data += sizeof(ObjHeap);
+
+    /* setup the handle array */
+    heap->handles = (VMHANDLE)(data + dataSize);
+    heap->endHandles = heap->handles + nHandles;
+    heap->nHandles = nHandles;
+    heap->data = data;
+
+    /* code and VMVALUE fields can only hold handles that fit in a VMUVALUE */
+    if (ValueToHandle(HandleToValue(heap->endHandles)) != heap->endHandles)
+        Abort(sys, "handles don't fit in a VMVALUE (build with -no-pie)");
+
+    /* initialize the heap */
+    ResetHeap(heap);
+    
+    /* return the new heap */
+    return heap;
+}
+
+/* ResetHeap - reset the heap to its intial state */
+void ResetHeap(ObjHeap *heap)
+{
+    VMHANDLE handle;
+    int cnt;
+    
+    /* create the handle free list */
+    heap->freeHandles = NULL;
+    for (handle = heap->handles, cnt = heap->nHandles; --cnt >= 0; ++handle) {
+        *handle = (void *)heap->freeHandles;
+        heap->freeHandles = handle;
+    }
+
+    /* setup the heap free space */
+    heap->free = heap->data;
+    memset(heap->freeLists, 0, sizeof(heap->freeLists));
+    heap->compactScan = heap->compactNext = NULL;
+    memset(&heap->compactStats, 0, sizeof(heap->compactStats));
+    heap->bytesSaved = 0;
+    
+    /* initialize the global symbol table */
+    InitSymbolTable(&heap->globals);
+
+    /* initialize the common types */
+    InitCommonType(heap, integerType, TYPE_INTEGER);
+    InitCommonType(heap, integerArrayType, TYPE_ARRAY);
+    heap->integerArrayType.type.u.arrayInfo.elementType = CommonType(heap, integerType);
+    InitCommonType(heap, byteType, TYPE_BYTE);
+    InitCommonType(heap, byteArrayType, TYPE_ARRAY);
+    heap->byteArrayType.type.u.arrayInfo.elementType = CommonType(heap, byteType);
+    InitCommonType(heap, stringType,TYPE_STRING);
+    InitCommonType(heap, stringArrayType, TYPE_ARRAY);
+    heap->stringArrayType.type.u.arrayInfo.elementType = CommonType(heap, stringType);
+
+    /* add the intrinsic functions */
+    heap->nIntrinsics = 0;
+    AddIntrinsic(heap, "ABS",          abs,        "i=i",    INTRINSIC_PURE)
+    AddIntrinsic(heap, "RND",          rnd,        "i=i",    0)
+    AddIntrinsic(heap, "LEFT$",        left,       "s=si",   INTRINSIC_PURE)
+    AddIntrinsic(heap, "RIGHT$",       right,      "s=si",   INTRINSIC_PURE)
+    AddIntrinsic(heap, "MID$",         mid,        "s=sii",  0)
+    AddIntrinsic(heap, "CHR$",         chr,        "s=i",    INTRINSIC_PURE)
+    AddIntrinsic(heap, "STR$",         str,        "s=i",    INTRINSIC_PURE)
+    AddIntrinsic(heap, "VAL",          val,        "i=s",    INTRINSIC_PURE)
+    AddIntrinsic(heap, "ASC",          asc,        "i=s",    INTRINSIC_PURE)
+    AddIntrinsic(heap, "LEN",          len,        "i=s",    INTRINSIC_PURE)
+    AddIntrinsic(heap, "printStr",     printStr,   "=s",     0)
+    AddIntrinsic(heap, "printInt",     printInt,   "=i",     0)
+    AddIntrinsic(heap, "printTab",     printTab,   "=",      0)
+    AddIntrinsic(heap, "printNL",      printNL,    "=",      0)
+    AddIntrinsic(heap, "printFlush",   printFlush, "=",      0)
+    AddIntrinsic(heap, "GCSTATS",      gcstats,    "=",      0)
+    AddIntrinsic(heap, "CODESTATS",    codestats,  "=",      0)
+#ifdef JIT
+    AddIntrinsic(heap, "TIERS",        tiers,      "=",      0)
+    AddIntrinsic(heap, "SETTIERS",     settiers,   "=ii",    0)
+#endif
+}
+
+/* InitSymbolTable - initialize a symbol table */
+void InitSymbolTable(SymbolTable *table)
+{
+    table->head = NULL;
+    table->tail = NULL;
+    table->count = 0;
+}
+
+/* AddGlobal - add a global symbol to the symbol table */
+VMHANDLE AddGlobal(ObjHeap *heap, const char *name, StorageClass storageClass, VMHANDLE type)
+{
+    VMHANDLE symbol;
+    
+    /* allocate the symbol object */
+    if (!(symbol = NewSymbol(heap, name, storageClass, type)))
+        return NULL;
+        
+    /* add it to the symbol table */
+    if (heap->globals.tail == NULL)
+        heap->globals.head = heap->globals.tail = symbol;
+    else {
+        Symbol *last = GetSymbolPtr(heap->globals.tail);
+        heap->globals.tail = symbol;
+        last->next = symbol;
+    }
+    ++heap->globals.count;
+    
+    /* return the symbol */
+    return symbol;
+}
+
+/* FindGlobal - find a symbol in the global symbol table */
+VMHANDLE FindGlobal(ObjHeap *heap, const char *name)
+{
+    VMHANDLE symbol = heap->globals.head;
+    while (symbol) {
+        Symbol *sym = GetSymbolPtr(symbol);
+        if (strcasecmp(name, sym->name) == 0)
+            return symbol;
+        symbol = sym->next;
+    }
+    return NULL;
+}
+
+/* DumpGlobals - dump the global symbol table */
+void DumpGlobals(ObjHeap *heap)
+{
+    VMHANDLE symbol = heap->globals.head;
+    if (symbol) {
+        VM_printf("Globals:\n");
+        while (symbol) {
+            Symbol *sym = GetSymbolPtr(symbol);
+            VM_printf("  %s %04x\n", sym->name, sym->v.iValue);
+            symbol = sym->next;
+        }
+    }
+}
+
+/* AddLocal - add a symbol to a local symbol table */
+VMHANDLE AddLocal(ObjHeap *heap, SymbolTable *table, const char *name, VMHANDLE type, VMVALUE offset)
+{
+    VMHANDLE local;
+    
+    /* allocate the local symbol object */
+    if (!(local = NewLocal(heap, name, type, offset)))
+        return NULL;
+        
+    /* add it to the symbol table */
+    if (table->tail == NULL)
+        table->head = table->tail = local;
+    else {
+        Local *last = GetLocalPtr(table->tail);
+        table->tail = local;
+        last->next = local;
+    }
+    ++table->count;
+    
+    /* return the symbol */
+    return local;
+}
+
+/* FindLocal - find a local symbol in a symbol table */
+VMHANDLE FindLocal(SymbolTable *table, const char *name)
+{
+    VMHANDLE local = table->head;
+    while (local) {
+        Local *sym = GetLocalPtr(local);
+        if (strcasecmp(name, sym->name) == 0)
+            return local;
+        local = sym->next;
+    }
+    return NULL;
+}
+
+/* DumpLocals - dump a local symbol table */
+void DumpLocals(SymbolTable *table, const char *tag)
+{
+    VMHANDLE symbol;
+    if ((symbol = table->head) != NULL) {
+        VM_printf("%s:\n", tag);
+        while (symbol) {
+            Local *sym = GetLocalPtr(symbol);
+            VM_printf("  %s %d\n", sym->name, sym->offset);
+            symbol = sym->next;
+        }
+    }
+}
+
+/* AddIntrinsic1 - add an intrinsic function to the global symbol table */
+void AddIntrinsic1(ObjHeap *heap, char *name, char *types, VMHANDLE handler, int flags)
+{
+    char returnType = *types;
+    int argumentCount, handleArgumentCount;
+    VMHANDLE symbol, type, argType;
+    SymbolTable arguments;
+    Type *typ;
+    
+    /* make the function type */
+    if (!(type = NewType(heap, TYPE_FUNCTION)))
+        longjmp(heap->sys->errorTarget, 1);
+    typ = GetTypePtr(type);
+    InitSymbolTable(&arguments);
+    
+    /* set the return type */
+    switch (*types++) {
+    case 'i':
+        typ->u.functionInfo.returnType = CommonType(heap, integerType);
+        break;
+    case 's':
+        typ->u.functionInfo.returnType = CommonType(heap, stringType);
+        break;
+    case '=':
+        /* no return value so leave the '=' for the argument types */
+        typ->u.functionInfo.returnType = NULL;
+        --types;
+        break;
+    default:
+        longjmp(heap->sys->errorTarget, 1);
+    }
+    
+    /* initialize the argument counts */
+    argumentCount = handleArgumentCount = 0;
+    
+    /* add the argument types */
+    if (*types++ == '=') {
+        while (*types) {
+            switch (*types++) {
+            case 'i':
+                argType = CommonType(heap, integerType);
+                ++argumentCount;
+                break;
+            case 's':
+                argType = CommonType(heap, stringType);
+                ++handleArgumentCount;
+                break;
+            default:
+                longjmp(heap->sys->errorTarget, 1);
+            }
+            AddLocal(heap, &arguments, "", argType, 0);
+        }
+    }
+
+    /* add a global symbol for the intrinsic function */
+    if (!(symbol = AddGlobal(heap, name, SC_CONSTANT, type)))
+        longjmp(heap->sys->errorTarget, 1);
+    GetSymbolPtr(symbol)->v.hValue = handler;
+
+    /* store the argument symbol table */
+    typ = GetTypePtr(type);
+    typ->u.functionInfo.arguments = arguments;
+
+    /* add it to the intrinsic table so OP_CALLI can call it (the rest use OP_CALL) */
+    if (heap->nIntrinsics < MAXINTRINSICS) {
+        IntrinsicInfo *info = &heap->intrinsicInfo[heap->nIntrinsics];
+        info->argumentCount = argumentCount;
+        info->handleArgumentCount = handleArgumentCount;
+        info->returnType = returnType;
+        info->flags = flags;
+        heap->intrinsics[heap->nIntrinsics++] = GetIntrinsicHandler(handler);
+    }
+}
+
+/* IntrinsicIndex - find the index of an intrinsic function in the intrinsic table (or -1) */
+int IntrinsicIndex(ObjHeap *heap, VMHANDLE fcn)
+{
+    int n;
+    if (fcn && GetHeapObjType(fcn) == ObjTypeIntrinsic) {
+        for (n = 0; n < heap->nIntrinsics; ++n)
+            if (heap->intrinsics[n] == GetIntrinsicHandler(fcn))
+                return n;
+    }
+    return -1;
+}
+
+/* NewSymbol - create a new symbol object */
+VMHANDLE NewSymbol(ObjHeap *heap, const char *name, StorageClass storageClass, VMHANDLE type)
+{
+    size_t size = sizeof(Symbol) + strlen(name);
+    VMHANDLE object;
+    Symbol *sym;
+    
+    /* allocate a symbol object */
+    if (!(object = ObjAlloc(heap, ObjTypeSymbol, size)))
+        return NULL;
+        
+    /* initialze the symbol */
+    sym = GetSymbolPtr(object);
+    memset(sym, 0, sizeof(Symbol));
+    strcpy(sym->name, name);
+    sym->storageClass = storageClass;
+    sym->type = type;
+
+    /* return the object */
+    return object;
+}
+
+/* NewLocal - create a new local symbol object */
+VMHANDLE NewLocal(ObjHeap *heap, const char *name, VMHANDLE type, VMVALUE offset)
+{
+    size_t size = sizeof(Local) + strlen(name);
+    VMHANDLE object;
+    Local *sym;
+    
+    /* allocate an argument object */
+    if (!(object = ObjAlloc(heap, ObjTypeLocal, size)))
+        return NULL;
+        
+    /* initialze the argument */
+    sym = GetLocalPtr(object);
+    memset(sym, 0, sizeof(Local));
+    strcpy(sym->name, name);
+    sym->type = type;
+    sym->offset = offset;
+
+    /* return the object */
+    return object;
+}
+
+/* NewType - create a new type object */
+VMHANDLE NewType(ObjHeap *heap, TypeID id)
+{
+    VMHANDLE object;
+    Type *type;
+    
+    /* allocate a type object */
+    if (!(object = ObjAlloc(heap, ObjTypeType, sizeof(Type))))
+        return NULL;
+        
+    /* initialze the type */
+    type = (Type *)GetHeapObjPtr(object);
+    memset(type, 0, sizeof(Type));
+    type->id = id;
+
+    /* return the object */
+    return object;
+}
+
+/* IsHandleType - check to see if a type is a heap object */
+int IsHandleType(VMHANDLE type)
+{
+    switch (GetTypePtr(type)->id) {
+    case TYPE_STRING:
+    case TYPE_ARRAY:
+    case TYPE_FUNCTION:
+        return VMTRUE;
+    default:
+        return VMFALSE;
+    }
+}
+
+/* NewCode - create a new code object */
+VMHANDLE NewCode(ObjHeap *heap, size_t size)
+{
+    return ObjAlloc(heap, ObjTypeCode, size);
+}
+
+/* NewString - create a new string object */
+VMHANDLE NewString(ObjHeap *heap, size_t size)
+{
+    return ObjAlloc(heap, ObjTypeString, size);
+}
+
+/* NewStringSlice - create a new string slice object
+ *
+ * The slice keeps a reference to the string it is part of. A slice of a
+ * slice refers to the original string instead.
+ */
+VMHANDLE NewStringSlice(ObjHeap *heap, VMHANDLE string, size_t offset, size_t length)
+{
+    StringSlice *slice;
+    VMHANDLE object;
+    if (IsStringSlice(string)) {
+        offset += GetStringSlicePtr(string)->offset;
+        string = GetStringSlicePtr(string)->string;
+    }
+    if (!(object = ObjAlloc(heap, ObjTypeStringSlice, sizeof(StringSlice))))
+        return NULL;
+    slice = GetStringSlicePtr(object);
+    slice->string = string;
+    slice->offset = offset;
+    slice->length = length;
+    ObjAddRef(string);
+    return object;
+}
+
+/* InternString - get an immortal string object with the same characters as a string literal
+ *
+ * Identical literals anywhere in the program share one string object. The
+ * heap itself is the table of them since it is reset when the program is.
+ */
+VMHANDLE InternString(ObjHeap *heap, const uint8_t *buf, size_t size)
+{
+    uint8_t *data = heap->data;
+    VMHANDLE string;
+
+    /* look for an existing string literal */
+    while (data < heap->free) {
+        ObjHdr *hdr = (ObjHdr *)data;
+        if (hdr->handle
+        &&  hdr->type == ObjTypeString
+        &&  (hdr->flags & OBJ_IMMORTAL)
+        &&  hdr->size == size
+        &&  memcmp(hdr + 1, buf, size) == 0)
+            return hdr->handle;
+        data += BlockSize(hdr);
+    }
+
+    /* make a new one */
+    if ((string = StoreByteVector(heap, ObjTypeString, buf, size)) != NULL)
+        GetHeapObjHdr(string)->flags |= OBJ_IMMORTAL;
+    return string;
+}
+
+/* StoreIntegerVector - store an integer vector object (filled with zeros if buf is NULL) */
+VMHANDLE StoreIntegerVector(ObjHeap *heap, const VMVALUE *buf, size_t size)
+{
+    VMHANDLE object;
+    VMVALUE *p;
+
+    /* allocate an integer vector object */
+    if (!(object = ObjAlloc(heap, ObjTypeIntegerVector, size)))
+        return NULL;
+    
+    /* copy the data into the vector object */
+    p = GetIntegerVectorBase(object);
+    while (size > 0) {
+        *p++ = buf ? *buf++ : 0;
+        --size;
+    }
+    
+    /* return the object */
+    return object;
+}
+
+/* StoreStringVector - store a string vector object (filled with NULL handles if buf is NULL) */
+VMHANDLE StoreStringVector(ObjHeap *heap, const VMHANDLE *buf, size_t size)
+{
+    VMHANDLE object;
+    VMHANDLE *p;
+
+    /* allocate a string vector object */
+    if (!(object = ObjAlloc(heap, ObjTypeStringVector, size)))
+        return NULL;
+    
+    /* copy the data into the vector object */
+    p = GetStringVectorBase(object);
+    while (size > 0) {
+        *p++ = buf ? *buf++ : NULL;
+        --size;
+    }
+    
+    /* return the object */
+    return object;
+}
+
+/* StoreByteVector - store a byte vector object */
+VMHANDLE StoreByteVector(ObjHeap *heap, ObjType type, const uint8_t *buf, size_t size)
+{
+    VMHANDLE object;
+    uint8_t *p;
+
+    /* allocate byte vector object */
+    if (!(object = ObjAlloc(heap, type, size)))
+        return NULL;
+    
+    /* copy the data into the byte vector object */
+    p = GetByteVectorBase(object);
+    while (size > 0) {
+        *p++ = *buf++;
+        --size;
+    }
+    
+    /* return the object */
+    return object;
+}
+
+/* StoreByteVectorData - store data for a previously allocated byte vector object */
+int StoreByteVectorData(ObjHeap *heap, VMHANDLE object, const uint8_t *buf, size_t size)
+{
+    uint8_t *p;
+
+    /* allocate byte vector object */
+    if (!ObjRealloc(heap, object, size))
+        return VMFALSE;
+    
+    /* copy the data into the byte vector object */
+    p = GetByteVectorBase(object);
+    while (size > 0) {
+        *p++ = *buf++;
+        --size;
+    }
+    
+    /* return the object */
+    return VMTRUE;
+}
+
+/* ObjAlloc - allocate a new object */
+VMHANDLE ObjAlloc(ObjHeap *heap, ObjType type, size_t size)
+{
+    return ObjAllocExtra(heap, type, size, 0);
+}
+
+/* ObjAllocExtra - allocate a new object followed by free space for that many more elements
+ *
+ * The free space is left as a free block for ObjExtend to grow the object
+ * into. The object is allocated without it if there isn't room for both.
+ */
+VMHANDLE ObjAllocExtra(ObjHeap *heap, ObjType type, size_t size, size_t extra)
+{
+    size_t byteSize = size * elementSizes[type];
+    size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
+    size_t extraSize = extra > 0 ? sizeof(ObjHdr) + WORDSIZE(extra * elementSizes[type]) : 0;
+    VMHANDLE handle;
+    ObjHdr *hdr;
+
+    /* find a free handle */
+    if (!(handle = heap->freeHandles))
+        return NULL;
+
+    /* remove the handle from the free list */
+    heap->freeHandles = (VMHANDLE)*handle;
+
+    /* use a free block if there is one big enough */
+    if (!(hdr = TakeFreeBlock(heap, totalSize + extraSize))) {
+
+        /* move a compaction cycle along if the space at the end of the heap is getting low */
+        if (heap->compactScan
+        ||  (uint8_t *)heap->handles - heap->free < totalSize + extraSize
+                                                  + ((uint8_t *)heap->handles - heap->data) / COMPACT_RESERVE)
+            CompactHeapStep(heap, COMPACT_STEP + COMPACT_RATIO * (totalSize + extraSize));
+
+        /* finish the cycle at once if there still isn't enough space */
+        if ((uint8_t *)heap->handles - heap->free < totalSize + extraSize) {
+            CompactHeap(heap);
+            if ((uint8_t *)heap->handles - heap->free < totalSize + extraSize)
+                extraSize = 0;
+            if ((uint8_t *)heap->handles - heap->free < totalSize) {
+                *handle = (void *)heap->freeHandles;
+                heap->freeHandles = handle;
+                return NULL;
+            }
+        }
+
+        /* allocate the next available block */
+        hdr = (ObjHdr *)heap->free;
+        heap->free += totalSize + extraSize;
+    }
+
+    /* leave the extra space after it as a free block */
+    if (extraSize > 0)
+        MakeFreeBlock((uint8_t *)hdr + totalSize, (uint8_t *)hdr + totalSize + extraSize);
+    
+    /* store the backpointer and length */
+    hdr->handle = handle;
+    hdr->type = type;
+    hdr->size = size;
+    hdr->refCnt = 1;
+    hdr->flags = 0;
+    
+    /* store the pointer from the handle to the heap data */
+    *handle = (void *)(hdr + 1);
+
+    /* return successfully */
+    return handle;
+}
+
+/* ObjRealloc - reallocate space for an object */
+int ObjRealloc(ObjHeap *heap, VMHANDLE handle, size_t size)
+{
+    ObjHdr *hdr = GetHeapObjHdr(handle);
+    size_t byteSize = size * elementSizes[hdr->type];
+    size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
+    VMUVALUE refCnt;
+    uint8_t type, flags;
+
+    /* make sure there's enough space (compacting the heap can move the object) */
+    if ((uint8_t *)heap->handles - heap->free < totalSize) {
+        CompactHeap(heap);
+        if ((uint8_t *)heap->handles - heap->free < totalSize)
+            return VMFALSE;
+        hdr = GetHeapObjHdr(handle);
+    }
+    
+    /* get the old type and reference count and free the old data space */
+    type = hdr->type;
+    refCnt = hdr->refCnt;
+    flags = hdr->flags;
+    AddFreeBlock(heap, hdr);
+
+    /* allocate the new space */
+    hdr = (ObjHdr *)heap->free;
+    heap->free += totalSize;
+    
+    /* store the backpointer and length */
+    hdr->handle = handle;
+    hdr->type = type;
+    hdr->size = size;
+    hdr->refCnt = refCnt;
+    hdr->flags = flags;
+    
+    /* store the pointer from the handle to the heap data */
+    *handle = (void *)(hdr + 1);
+
+    /* return successfully */
+    return VMTRUE;
+}
+
+/* ObjExtend - grow an object in place into the free space after it
+ *
+ * Free blocks after the object that aren't on a free list or the space
+ * left behind by a compaction cycle in progress and the unallocated space
+ * at the end of the heap can be used. Returns VMFALSE if there isn't enough
+ * of it. This never compacts the heap so pointers into other objects stay
+ * valid.
+ */
+int ObjExtend(ObjHeap *heap, VMHANDLE handle, size_t size)
+{
+    ObjHdr *hdr = GetHeapObjHdr(handle);
+    uint8_t *data = (uint8_t *)hdr;
+    uint8_t *end = data + sizeof(ObjHdr) + WORDSIZE(size * elementSizes[hdr->type]);
+    uint8_t *next = data + BlockSize(hdr);
+
+    /* take in the free blocks that follow the object */
+    while (next < end && next < heap->free && next != heap->compactNext
+    &&     !((ObjHdr *)next)->handle && !(((ObjHdr *)next)->flags & OBJ_FREELIST))
+        next += BlockSize((ObjHdr *)next);
+
+    /* use the unallocated space if the object ends up at the end of the heap */
+    if (next == heap->free) {
+        if (end > (uint8_t *)heap->handles)
+            return VMFALSE;
+        heap->free = end;
+    }
+
+    /* otherwise, any space left over has to be big enough to make a free block of its own */
+    else if (next != end) {
+        if (next < end || (size_t)(next - end) < sizeof(ObjHdr))
+            return VMFALSE;
+        MakeFreeBlock(end, next);
+    }
+
+    /* store the new size */
+    hdr->size = size;
+    return VMTRUE;
+}
+
+/* MakeFreeBlock - turn a range of the heap into a free block */
+static void MakeFreeBlock(uint8_t *data, uint8_t *end)
+{
+    ObjHdr *hdr = (ObjHdr *)data;
+    hdr->handle = NULL;
+    hdr->refCnt = 0;
+    hdr->type = ObjTypeByteVector;
+    hdr->flags = 0;
+    hdr->size = end - data - sizeof(ObjHdr);
+}
+
+/* free lists
+ *
+ * A freed block goes on a free list so ObjAlloc can use it again without
+ * compacting the heap. Blocks with fewer than NFREELISTS - 1 words of data
+ * have a list for each size and larger ones share the last list. A block
+ * on a list has OBJ_FREELIST set and its refCnt field links it to the next
+ * one. A compaction cycle empties the lists when it starts and blocks it
+ * hasn't reached yet are left off them until it finishes.
+ */
+
+/* FreeListIndex - get the index of the free list for a block size */
+#define FreeListIndex(totalSize) \
+            ((totalSize) - sizeof(ObjHdr) < (NFREELISTS - 1) * sizeof(VMVALUE) \
+                ? (int)(((totalSize) - sizeof(ObjHdr)) / sizeof(VMVALUE)) \
+                : NFREELISTS - 1)
+
+/* AddFreeBlock - free a block and put it on the free list for its size */
+static void AddFreeBlock(ObjHeap *heap, ObjHdr *hdr)
+{
+    int index = FreeListIndex(BlockSize(hdr));
+    hdr->handle = NULL;
+    if (heap->compactScan && (uint8_t *)hdr >= heap->compactScan) {
+        hdr->flags = 0;
+        return;
+    }
+    hdr->flags = OBJ_FREELIST;
+    hdr->refCnt = heap->freeLists[index];
+    heap->freeLists[index] = (VMUVALUE)((uint8_t *)hdr - heap->data) + 1;
+}
+
+/* TakeFreeBlock - take a free block of a given size off of the free lists
+ *
+ * A block from the last list can be bigger as long as what is left over
+ * makes a free block of its own.
+ */
+static ObjHdr *TakeFreeBlock(ObjHeap *heap, size_t totalSize)
+{
+    int index = FreeListIndex(totalSize);
+    ObjHdr *hdr;
+    if (index < NFREELISTS - 1 && (hdr = TakeFreeBlock1(heap, index, totalSize)) != NULL)
+        return hdr;
+    return TakeFreeBlock1(heap, NFREELISTS - 1, totalSize);
+}
+
+/* TakeFreeBlock1 - take a free block of a given size off of one free list */
+static ObjHdr *TakeFreeBlock1(ObjHeap *heap, int index, size_t totalSize)
+{
+    VMUVALUE *pLink = &heap->freeLists[index];
+    size_t blockSize;
+    ObjHdr *hdr;
+    while (*pLink) {
+        hdr = (ObjHdr *)(heap->data + *pLink - 1);
+        blockSize = BlockSize(hdr);
+        if (blockSize == totalSize || blockSize >= totalSize + sizeof(ObjHdr)) {
+            *pLink = hdr->refCnt;
+            if (blockSize > totalSize) {
+                MakeFreeBlock((uint8_t *)hdr + totalSize, (uint8_t *)hdr + blockSize);
+                AddFreeBlock(heap, (ObjHdr *)((uint8_t *)hdr + totalSize));
+            }
+            return hdr;
+        }
+        pLink = &hdr->refCnt;
+    }
+    return NULL;
+}
+
+/* ObjRelease - release a reference to an object */
+void ObjRelease(ObjHeap *heap, VMHANDLE object)
+{
+    ObjRelease1(heap, DereferenceAndMaybePushObject(NULL, object));
+}
+
+/* ReleaseCode - release references in a block of code */
+void ReleaseCode(ObjHeap *heap, uint8_t *code, size_t size)
+{
+    ObjRelease1(heap, TraceCode(NULL, code, size));
+}
+    
+/* ObjRelease1 - release a reference to an object */
+static void ObjRelease1(ObjHeap *heap, VMHANDLE stack)
+{
+    VMHANDLE object;
+    
+    /* trace objects until the stack is empty */
+    while ((object = stack) != NULL) {
+        ObjHdr *hdr = GetHeapObjHdr(object);
+        
+        /* pop the stack */
+        stack = hdr->handle;
+        hdr->handle = object;
+    
+        /* push any embedded object references */
+        switch (hdr->type) {
+        case ObjTypeStringVector:
+        {
+            VMHANDLE *base = GetStringVectorBase(object);
+            size_t i;
+            for (i = 0; i < hdr->size; ++i)
+                stack = DereferenceAndMaybePushObject(stack, base[i]);
+            break;
+        }
+        case ObjTypeSymbol:
+        {
+            Symbol *symbol = GetSymbolPtr(object);
+            stack = DereferenceAndMaybePushObject(stack, symbol->next);
+            stack = DereferenceAndMaybePushObject(stack, symbol->type);
+            if (IsHandleType(symbol->type))
+                stack = DereferenceAndMaybePushObject(stack, symbol->v.hValue);
+            break;
+        }
+        case ObjTypeLocal:
+        {
+            Local *local = GetLocalPtr(object);
+            stack = DereferenceAndMaybePushObject(stack, local->next);
+            stack = DereferenceAndMaybePushObject(stack, local->type);
+            break;
+        }
+        case ObjTypeType:
+        {
+            Type *type = GetTypePtr(object);
+            switch (type->id) {
+            case TYPE_ARRAY:
+                stack = DereferenceAndMaybePushObject(stack, type->u.arrayInfo.elementType);
+                break;
+            case TYPE_FUNCTION:
+                stack = DereferenceAndMaybePushObject(stack, type->u.functionInfo.returnType);
+                stack = DereferenceAndMaybePushObject(stack, type->u.functionInfo.arguments.head);
+                break;
+            default:
+                /* no internal references */
+                break;
+            }
+            break;
+        }
+        case ObjTypeCode:
+            stack = TraceCode(stack, GetCodePtr(object), hdr->size);
+            break;
+        case ObjTypeStringSlice:
+            stack = DereferenceAndMaybePushObject(stack, GetStringSlicePtr(object)->string);
+            break;
+        default:    /* no internal references */
+            /* should never get here */
+            break;
+        }
+
+        /* free the object */
+        *object = (void *)heap->freeHandles;
+        heap->freeHandles = object;
+        AddFreeBlock(heap, hdr);
+    }
+}
+
+/* DereferenceAndMaybePushObject - dereference an object and push it onto the trace stack if refCnt goes to zero */
+static VMHANDLE DereferenceAndMaybePushObject(VMHANDLE stack, VMHANDLE object)
+{
+    if (object != NULL) {
+        ObjHdr *hdr = GetHeapObjHdr(object);
+        if (hdr->handle && !(hdr->flags & OBJ_IMMORTAL) && --hdr->refCnt == 0) {
+            hdr->handle = stack;
+            stack = object;
+        }
+    }
+    return stack;
+}
+
+/* TraceCode - trace object references in a code object */
+static VMHANDLE TraceCode(VMHANDLE stack, uint8_t *code, size_t size)
+{
+    uint8_t *p = code;
+    uint8_t *end = p + size;
+    while (p < end) {
+        switch (*p++) {
+        case OP_HALT:
+            break;
+        case OP_BRT:
+        case OP_BRTSC:
+        case OP_BRF:
+        case OP_BRFSC:
+        case OP_BR:
+            p += sizeof(VMVALUE);
+            break;
+        case OP_NOT:
+        case OP_NEG:
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_REM:
+        case OP_BNOT:
+        case OP_BAND:
+        case OP_BOR:
+        case OP_BXOR:
+        case OP_SHL:
+        case OP_SHR:
+        case OP_LT:
+        case OP_LE:
+        case OP_EQ:
+        case OP_NE:
+        case OP_GE:
+        case OP_GT:
+            break;
+        case OP_LIT:
+            p += sizeof(VMVALUE);
+            break;
+        case OP_LREF:
+        case OP_LSET:
+        case OP_LTEE:
+        case OP_LREFH:
+        case OP_LSETH:
+        case OP_LAPPH:
+        case OP_CALLI:
+        case OP_CATN:
+        case OP_SCMP:
+            p += 1;
+            break;
+        case OP_VREF:
+        case OP_VSET:
+        case OP_VREFH:
+        case OP_VSETH:
+        case OP_VREFU:
+        case OP_VSETU:
+            break;
+        case OP_RESERVE:
+            p += FD_SIZE - 1;
+            break;
+        case OP_RETURN:
+        case OP_RETURNH:
+        case OP_RETURNV:
+        case OP_CALL:
+        case OP_TCALL:
+        case OP_DROP:
+        case OP_DROPH:
+            break;
+        case OP_ADDI:
+        case OP_BRLT:
+        case OP_BRLE:
+        case OP_BREQ:
+        case OP_BRNE:
+        case OP_BRGE:
+        case OP_BRGT:
+            p += sizeof(VMVALUE);
+            break;
+        case OP_LINC:
+            p += 1 + sizeof(VMVALUE);
+            break;
+        case OP_LREF2:
+            p += 2;
+            break;
+        case OP_LBRLT:
+        case OP_LBRLE:
+        case OP_LBREQ:
+        case OP_LBRNE:
+        case OP_LBRGE:
+        case OP_LBRGT:
+            p += 1 + 2 * sizeof(VMVALUE);
+            break;
+        case OP_FORL:
+        case OP_NEXTL:
+            p += 2 + sizeof(VMVALUE);
+            break;
+        case OP_FORG:
+        case OP_NEXTG:
+        {
+            VMVALUE tmp;
+            get_VMVALUE(tmp, *p++);
+            stack = DereferenceAndMaybePushObject(stack, ValueToHandle(tmp));
+            p += 1 + sizeof(VMVALUE);
+            break;
+        }
+        case OP_LITH:
+        case OP_GREF:
+        case OP_GSET:
+        case OP_GREFH:
+        case OP_GSETH:
+        case OP_GAPPH:
+        {
+            VMVALUE tmp;
+            get_VMVALUE(tmp, *p++);
+            stack = DereferenceAndMaybePushObject(stack, ValueToHandle(tmp));
+            break;
+        }
+        case OP_CAT:
+            break;
+        default:
+            /* should never reach */
+            break;
+        }
+    }
+    
+    return stack;
+}
+
+/* CompactHeapStep - do one step of a compaction cycle
+ *
+ * A cycle slides the live objects down to the bottom of the heap a few at a
+ * time. Between steps the objects below compactNext are in place, the space
+ * from there up to compactScan is a single free block and the blocks from
+ * compactScan up haven't been looked at yet. A step stops once it has moved
+ * budget bytes counting each block it only looks at as the size of its
+ * header. Returns VMTRUE if the cycle is finished.
+ */
+int CompactHeapStep(ObjHeap *heap, size_t budget)
+{
+    VMUVALUE start = VM_ticks();
+    uint8_t *data, *next, *free;
+    size_t cost;
+    int done;
+    
+    /* call the client's before function */
+    if (heap->beforeCompact)
+        (*heap->beforeCompact)(heap->compactCookie);
+
+    /* start a new cycle (the blocks on the free lists are going to be moved over) */
+    if (!heap->compactScan) {
+        data = next = heap->data;
+        memset(heap->freeLists, 0, sizeof(heap->freeLists));
+    }
+
+    /* or continue the one in progress */
+    else {
+        data = heap->compactScan;
+        next = heap->compactNext;
+    }
+    free = heap->free;
+
+    /* compact the heap */
+    while (data < free && budget > 0) {
+        ObjHdr *hdr = (ObjHdr *)data;
+        size_t totalSize = BlockSize(hdr);
+        cost = sizeof(ObjHdr);
+        if (hdr->handle) {
+            if (data != next) {
+                *hdr->handle = (void *)(next + sizeof(ObjHdr));
+                memmove(next, data, totalSize);
+                cost = totalSize;
+            }
+            next += totalSize;
+        }
+        data += totalSize;
+        budget = cost < budget ? budget - cost : 0;
+    }
+
+    /* store the new free pointer at the end of the cycle */
+    if (data >= free) {
+        heap->free = next;
+        heap->compactScan = heap->compactNext = NULL;
+        ++heap->compactStats.cycles;
+        done = VMTRUE;
+    }
+
+    /* otherwise, leave a free block between the objects moved and the rest */
+    else {
+        if (data != next)
+            MakeFreeBlock(next, data);
+        heap->compactScan = data;
+        heap->compactNext = next;
+        done = VMFALSE;
+    }
+
+    /* keep track of how long the step took */
+    RecordPause(heap, VM_ticks() - start);
+
+    /* call the client's after function */
+    if (heap->afterCompact)
+        (*heap->afterCompact)(heap->compactCookie);
+
+    return done;
+}
+
+/* CompactHeap - compact the heap all at once (finishing any cycle in progress) */
+void CompactHeap(ObjHeap *heap)
+{
+    CompactHeapStep(heap, (size_t)~0);
+}
+
+/* RecordPause - add the length of a compaction step to the statistics */
+static void RecordPause(ObjHeap *heap, VMUVALUE ticks)
+{
+    CompactStats *stats = &heap->compactStats;
+    int n = 0;
+    while (n < NPAUSEBUCKETS - 1 && (ticks >> n) != 0)
+        ++n;
+    ++stats->pauses[n];
+    ++stats->steps;
+    if (ticks > stats->maxPause)
+        stats->maxPause = ticks;
+}
+
+/* DumpHeap - dump the heap */
+void DumpHeap(ObjHeap *heap)
+{
+    uint8_t *data, *free;
+
+    /* initialize the heap scan */
+    data = heap->data;
+    free = heap->free;
+
+    /* compact the heap */
+    while (data < free) {
+        ObjHdr *hdr = (ObjHdr *)data;
+        size_t byteSize = hdr->size * elementSizes[hdr->type];
+        size_t totalSize = sizeof(ObjHdr) + WORDSIZE(byteSize);
+        VM_printf("%p h: %p, c: %d, t: %s, s: %d\n",
+                  hdr,
+                  hdr->handle,
+                  hdr->refCnt,
+                  typeNames[hdr->type],
+                  hdr->size);
+        if (hdr->handle) {
+            switch (hdr->type) {
+            case ObjTypeIntegerVector:
+                break;
+            case ObjTypeStringVector:
+                break;
+            case ObjTypeByteVector:
+                break;
+            case ObjTypeSymbol:
+            {
+                Symbol *sym = GetSymbolPtr(hdr->handle);
+                char *p = sym->name;
+                VM_printf("    ");
+                while (*p) 
+                    VM_putchar(*p++);
+                VM_putchar('\n');
+                break;
+            }
+            case ObjTypeLocal:
+            {
+                Local *sym = GetLocalPtr(hdr->handle);
+                char *p = sym->name;
+                VM_printf("    ");
+                while (*p) 
+                    VM_putchar(*p++);
+                VM_putchar('\n');
+                break;
+            }
+            case ObjTypeType:
+                break;
+            case ObjTypeString:
+            {
+                size_t cnt = hdr->size;
+                uint8_t *p = GetStringPtr(hdr->handle);
+                VM_printf("    \"");
+                while (cnt > 0) {
+                    VM_putchar(*p++);
+                    --cnt;
+                }
+                VM_printf("\"\n");
+                break;
+            }
+            case ObjTypeStringSlice:
+            {
+                StringSlice *slice = GetStringSlicePtr(hdr->handle);
+                VM_printf("    %p, o: %d, l: %d\n", slice->string, slice->offset, slice->length);
+                break;
+            }
+            case ObjTypeCode:
+            {
+                uint8_t *code = GetCodePtr(hdr->handle);
+                DecodeFunction((VMUVALUE)(uintptr_t)code, code, hdr->size);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        data += totalSize;
+    }
+}
+
+/* ShowHeapStats - show the heap space and the compaction statistics */
+void ShowHeapStats(ObjHeap *heap)
+{
+    CompactStats *stats = &heap->compactStats;
+    VMUVALUE limit;
+    int n;
+    VM_printf("heap %d bytes, %d unallocated\n", (uint8_t *)heap->handles - heap->data, (uint8_t *)heap->handles - heap->free);
+    VM_printf("compaction cycles %d, steps %d, longest pause %d\n", stats->cycles, stats->steps, stats->maxPause);
+    for (n = 0, limit = 1; n < NPAUSEBUCKETS; ++n, limit <<= 1) {
+        if (stats->pauses[n] > 0) {
+            if (n < NPAUSEBUCKETS - 1)
+                VM_printf("  under %d: %d\n", limit, stats->pauses[n]);
+            else
+                VM_printf("  %d or more: %d\n", limit >> 1, stats->pauses[n]);
+        }
+    }
+}
@@ -19,17 +19,23 @@ typedef enum {
     ObjTypeType,
     ObjTypeString,
     ObjTypeCode,
-    ObjTypeIntrinsic
+    ObjTypeIntrinsic,
+    ObjTypeStringSlice
 } ObjType;
 
 /* object header structure */
 typedef struct {
     VMHANDLE handle;
     VMUVALUE refCnt;
-    ObjType type;
+    uint8_t type;       /* ObjType */
+    uint8_t flags;      /* OBJ_xxx flags */
     size_t size;
 } ObjHdr;
 
+/* object header flags */
+#define OBJ_IMMORTAL    0x01    /* never freed so references aren't counted */
+#define OBJ_FREELIST    0x02    /* a free block on one of the heap free lists */
+
 /* storage class ids */
 typedef enum {
     SC_CONSTANT,
@@ -66,6 +72,13 @@ typedef struct {
     char name[1];
 } Local;
 
+/* string slice structure (the characters are those of a part of another string) */
+typedef struct {
+    VMHANDLE string;
+    size_t offset;
+    size_t length;
+} StringSlice;
+
 /* type ids */
 typedef enum {
     TYPE_UNKNOWN,
@@ -113,18 +126,27 @@ typedef struct {
             (c)->field.hdr.handle = NULL;               \
             (c)->field.hdr.refCnt = 0;                  \
             (c)->field.hdr.type = ObjTypeType;          \
+            (c)->field.hdr.flags = OBJ_IMMORTAL;        \
             (c)->field.hdr.size = sizeof(Type);
 
 /* get a handle to one of the common types */
 #define CommonType(c, field)        (&(c)->field.data)
 
 /* add an intrinsic function to the symbol table */
-#define AddIntrinsic(c, name, id, types)                            \
-            {                                                       \
-                id##_struct.data = (void *)&id##_struct.handler;    \
-                AddIntrinsic1(c, name, types, IntrinsicHandle(id)); \
+#define AddIntrinsic(c, name, id, types, flags)                             \
+            {                                                               \
+                id##_struct.data = (void *)&id##_struct.handler;            \
+                AddIntrinsic1(c, name, types, IntrinsicHandle(id), flags);  \
             }
 
+/* intrinsic function flags
+ *
+ * A pure function's result depends only on its arguments and it has no
+ * side effects or errors except that allocating a string result can run
+ * out of memory.
+ */
+#define INTRINSIC_PURE  0x01
+
 /* initialize a common type field */
 #define DefIntrinsic(name)                                                      \
             IntrinsicHandler fcn_##name;                                        \
@@ -134,6 +156,7 @@ typedef struct {
                                 NULL,                       /* hdr.handle */    \
                                 0,                          /* hdr.refCnt */    \
                                 ObjTypeIntrinsic,           /* hdr.type */      \
+                                OBJ_IMMORTAL,               /* hdr.flags */     \
                                 sizeof(IntrinsicHandler *)  /* hdr.size */      \
                             },                                                  \
                             fcn_##name                      /* handler */       \
@@ -152,17 +175,68 @@ typedef struct {
 #define GetStringPtr(h)         ((uint8_t *)GetHeapObjPtr(h))
 #define GetCodePtr(h)           ((uint8_t *)GetHeapObjPtr(h))
 #define GetIntrinsicHandler(h)  (*(IntrinsicHandler **)GetHeapObjPtr(h))
+#define GetStringSlicePtr(h)    ((StringSlice *)GetHeapObjPtr(h))
+
+/* macros to get the characters and length of a string or a string slice */
+#define IsStringSlice(h)        (GetHeapObjType(h) == ObjTypeStringSlice)
+#define GetStringData(h)        (IsStringSlice(h)                                                   \
+                                    ? GetStringPtr(GetStringSlicePtr(h)->string) + GetStringSlicePtr(h)->offset \
+                                    : GetStringPtr(h))
+#define GetStringSize(h)        (IsStringSlice(h) ? GetStringSlicePtr(h)->length : GetHeapObjSize(h))
 
 /* macro to get a pointer to an object in the heap */
 #define GetHeapObjPtr(h)        (*(h))
 #define GetHeapObjHdr(h)        ((ObjHdr *)*(h) - 1)
 #define GetHeapObjType(h)       (GetHeapObjHdr(h)->type)
 #define GetHeapObjSize(h)       (GetHeapObjHdr(h)->size)
+#define IsImmortal(h)           (GetHeapObjHdr(h)->flags & OBJ_IMMORTAL)
 #define ObjAddRef(h)            do {                                            \
-                                    if (h)                                      \
+                                    if ((h) && !IsImmortal(h))                  \
                                         ++GetHeapObjHdr(h)->refCnt;             \
                                 } while (0)
 
+/* size of the intrinsic function table (indexed by the byte operand of OP_CALLI) */
+#define MAXINTRINSICS   32
+
+/* stack effect and flags of an entry in the intrinsic function table */
+typedef struct {
+    uint8_t argumentCount;          /* number of value arguments */
+    uint8_t handleArgumentCount;    /* number of handle arguments */
+    char returnType;                /* 'i', 's' or '=' for none as in the AddIntrinsic types string */
+    uint8_t flags;                  /* INTRINSIC_xxx flags */
+} IntrinsicInfo;
+
+/* number of heap free lists (see AddFreeBlock in db_vmheap.c) */
+#define NFREELISTS      16
+
+/* incremental compaction (see CompactHeapStep in db_vmheap.c)
+ *
+ * A compaction cycle starts when an allocation would leave less than
+ * 1/COMPACT_RESERVE of the heap unallocated. Until it finishes each
+ * allocation that can't use a free block moves COMPACT_STEP bytes plus
+ * COMPACT_RATIO times its own size.
+ */
+#ifndef COMPACT_RESERVE
+#define COMPACT_RESERVE 4
+#endif
+#ifndef COMPACT_STEP
+#define COMPACT_STEP    256
+#endif
+#ifndef COMPACT_RATIO
+#define COMPACT_RATIO   4
+#endif
+
+/* number of buckets in the compaction pause histogram */
+#define NPAUSEBUCKETS   12
+
+/* heap compaction statistics (pause times are in VM_ticks units) */
+typedef struct {
+    VMUVALUE cycles;                /* number of compaction cycles completed */
+    VMUVALUE steps;                 /* number of compaction steps */
+    VMUVALUE maxPause;              /* longest step */
+    VMUVALUE pauses[NPAUSEBUCKETS]; /* steps by length, bucket n > 0 counts those under 2^n ticks */
+} CompactStats;
+
 /* heap structure */
 typedef struct {
     System *sys;                    /* system context */
@@ -172,6 +246,11 @@ typedef struct {
     VMHANDLE freeHandles;           /* list of free handles */
     uint8_t *data;                  /* heap data */
     uint8_t *free;                  /* next free heap location */
+    VMUVALUE freeLists[NFREELISTS]; /* free blocks by size (offsets plus one from data or zero) */
+    uint8_t *compactScan;           /* next block for the compaction cycle to look at or NULL */
+    uint8_t *compactNext;           /* where the compaction cycle moves the next live object */
+    CompactStats compactStats;      /* compaction cycles, steps and pause times */
+    VMUVALUE bytesSaved;            /* bytes the optimizer removed from the code since the last reset */
     SymbolTable globals;            /* global variables and constants */
     ConstantType integerType;       /* integer type */
     ConstantType integerArrayType;  /* integer array type */
@@ -179,6 +258,9 @@ typedef struct {
     ConstantType byteArrayType;     /* byte array type */
     ConstantType stringType;        /* string type */
     ConstantType stringArrayType;   /* string array type */
+    IntrinsicHandler *intrinsics[MAXINTRINSICS];    /* intrinsic function table */
+    IntrinsicInfo intrinsicInfo[MAXINTRINSICS];     /* stack effects and flags of the table entries */
+    int nIntrinsics;                /* number of intrinsic functions in the table */
     void (*beforeCompact)(void *cookie);
     void (*afterCompact)(void *cookie);
     void *compactCookie;
@@ -194,22 +276,29 @@ void DumpGlobals(ObjHeap *heap);
 VMHANDLE AddLocal(ObjHeap *heap, SymbolTable *table, const char *name, VMHANDLE type, VMVALUE offset);
 VMHANDLE FindLocal(SymbolTable *table, const char *name);
 void DumpLocals(SymbolTable *table, const char *tag);
-void AddIntrinsic1(ObjHeap *heap, char *name, char *types, VMHANDLE handler);
+void AddIntrinsic1(ObjHeap *heap, char *name, char *types, VMHANDLE handler, int flags);
+int IntrinsicIndex(ObjHeap *heap, VMHANDLE fcn);
 VMHANDLE NewSymbol(ObjHeap *heap, const char *name, StorageClass storageClass, VMHANDLE type);
 VMHANDLE NewLocal(ObjHeap *heap, const char *name, VMHANDLE type, VMVALUE offset);
 VMHANDLE NewType(ObjHeap *heap, TypeID id);
 int IsHandleType(VMHANDLE type);
 VMHANDLE NewCode(ObjHeap *heap, size_t size);
 VMHANDLE NewString(ObjHeap *heap, size_t size);
+VMHANDLE NewStringSlice(ObjHeap *heap, VMHANDLE string, size_t offset, size_t length);
+VMHANDLE InternString(ObjHeap *heap, const uint8_t *buf, size_t size);
 VMHANDLE StoreIntegerVector(ObjHeap *heap, const VMVALUE *buf, size_t size);
 VMHANDLE StoreStringVector(ObjHeap *heap, const VMHANDLE *buf, size_t size);
 VMHANDLE StoreByteVector(ObjHeap *heap, ObjType type, const uint8_t *buf, size_t size);
 int StoreByteVectorData(ObjHeap *heap, VMHANDLE object, const uint8_t *buf, size_t size);
 VMHANDLE ObjAlloc(ObjHeap *heap, ObjType type, size_t size);
+VMHANDLE ObjAllocExtra(ObjHeap *heap, ObjType type, size_t size, size_t extra);
+int ObjExtend(ObjHeap *heap, VMHANDLE handle, size_t size);
 int ObjRealloc(ObjHeap *heap, VMHANDLE handle, size_t size);
 void ObjRelease(ObjHeap *heap, VMHANDLE handle);
 void ReleaseCode(ObjHeap *heap, uint8_t *code, size_t size);
+int CompactHeapStep(ObjHeap *heap, size_t budget);
 void CompactHeap(ObjHeap *heap);
 void DumpHeap(ObjHeap *heap);
+void ShowHeapStats(ObjHeap *heap);
 
 #endif
@@ -1,417 +1,1627 @@
-/* db_vmint.c - bytecode interpreter for a simple virtual machine
- *
- * Copyright (c) 2009-2012 by David Michael Betz.  All rights reserved.
- *
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdarg.h>
-#include <string.h>
-#include <ctype.h>
-#include "db_vm.h"
-
-/* prototypes for local functions */
-static void StartCode(Interpreter *i);
-static void PopFrame(Interpreter *i);
-static void StringCat(Interpreter *i);
-static void AfterCompact(void *cookie);
-
-/* Execute - execute the main code */
-int Execute(System *sys, ObjHeap *heap, VMHANDLE main)
-{
-    size_t stackSize;
-    Interpreter *i;
-    VMVALUE tmp, tmp2, ind;
-    VMHANDLE obj, htmp;
-    int8_t tmpb;
-
-    /* allocate the interpreter state */
-    if (!(i = (Interpreter *)AllocateFreeSpace(sys, sizeof(Interpreter))))
-        return VMFALSE;
-
-    /* make sure there is space left for the stack */
-    if ((stackSize = (sys->freeTop - sys->freeNext) / sizeof(VMVALUE)) <= 0)
-        return VMFALSE;
-        
-    /* setup the heap before/after compact functions */
-    heap->beforeCompact = NULL;
-    heap->afterCompact = AfterCompact;
-    heap->compactCookie = i;
-    
-    /* initialize the interpreter state */
-    i->sys = sys;
-    i->heap = heap;
-    i->stack = (VMVALUE *)((uint8_t *)i + sizeof(Interpreter));
-    i->stackTop = i->stack + stackSize;
-    
-    /* setup to execute the main function */
-    i->code = main;
-    ObjAddRef(i->code);
-    i->cbase = i->pc = GetCodePtr(main);
-    i->sp = i->fp = i->stackTop;
-    i->hsp = i->hfp = (VMHANDLE *)i->stack - 1;
-
-    if (setjmp(i->sys->errorTarget)) {
-        while (i->hsp > (VMHANDLE *)i->stack)
-            ObjRelease(i->heap, PopH(i));
-        ObjRelease(i->heap, i->code);
-        return VMFALSE;
-    }
-
-    for (;;) {
-#if 0
-        ShowStack(i);
-        DecodeInstruction(0, 0, i->pc);
-#endif
-        switch (VMCODEBYTE(i->pc++)) {
-        case OP_HALT:
-            return VMTRUE;
-        case OP_BRT:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            if (Pop(i))
-                i->pc += tmp;
-            break;
-        case OP_BRTSC:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            if (*i->sp)
-                i->pc += tmp;
-            else
-                Drop(i, 1);
-            break;
-        case OP_BRF:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            if (!Pop(i))
-                i->pc += tmp;
-            break;
-        case OP_BRFSC:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            if (!*i->sp)
-                i->pc += tmp;
-            else
-                Drop(i, 1);
-            break;
-        case OP_BR:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            i->pc += tmp;
-            break;
-        case OP_NOT:
-            *i->sp = (*i->sp ? VMFALSE : VMTRUE);
-            break;
-        case OP_NEG:
-            *i->sp = -*i->sp;
-            break;
-        case OP_ADD:
-            tmp = Pop(i);
-            *i->sp += tmp;
-            break;
-        case OP_SUB:
-            tmp = Pop(i);
-            *i->sp -= tmp;
-            break;
-        case OP_MUL:
-            tmp = Pop(i);
-            *i->sp *= tmp;
-            break;
-        case OP_DIV:
-            tmp = Pop(i);
-            *i->sp = (tmp == 0 ? 0 : *i->sp / tmp);
-            break;
-        case OP_REM:
-            tmp = Pop(i);
-            *i->sp = (tmp == 0 ? 0 : *i->sp % tmp);
-            break;
-        case OP_CAT:
-            StringCat(i);
-            break;
-        case OP_BNOT:
-            *i->sp = ~*i->sp;
-            break;
-        case OP_BAND:
-            tmp = Pop(i);
-            *i->sp &= tmp;
-            break;
-        case OP_BOR:
-            tmp = Pop(i);
-            *i->sp |= tmp;
-            break;
-        case OP_BXOR:
-            tmp = Pop(i);
-            *i->sp ^= tmp;
-            break;
-        case OP_SHL:
-            tmp = Pop(i);
-            *i->sp <<= tmp;
-            break;
-        case OP_SHR:
-            tmp = Pop(i);
-            *i->sp >>= tmp;
-            break;
-        case OP_LT:
-            tmp = Pop(i);
-            *i->sp = (*i->sp < tmp ? VMTRUE : VMFALSE);
-            break;
-        case OP_LE:
-            tmp = Pop(i);
-            *i->sp = (*i->sp <= tmp ? VMTRUE : VMFALSE);
-            break;
-        case OP_EQ:
-            tmp = Pop(i);
-            *i->sp = (*i->sp == tmp ? VMTRUE : VMFALSE);
-            break;
-        case OP_NE:
-            tmp = Pop(i);
-            *i->sp = (*i->sp != tmp ? VMTRUE : VMFALSE);
-            break;
-        case OP_GE:
-            tmp = Pop(i);
-            *i->sp = (*i->sp >= tmp ? VMTRUE : VMFALSE);
-            break;
-        case OP_GT:
-            tmp = Pop(i);
-            *i->sp = (*i->sp > tmp ? VMTRUE : VMFALSE);
-            break;
-        case OP_LIT:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            CPush(i, tmp);
-            break;
-        case OP_GREF:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            obj = (VMHANDLE)tmp;
-            CPush(i, GetSymbolPtr(obj)->v.iValue);
-            break;
-        case OP_GSET:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            obj = (VMHANDLE)tmp;
-            GetSymbolPtr(obj)->v.iValue = Pop(i);
-            break;
-        case OP_LREF:
-            tmpb = (int8_t)VMCODEBYTE(i->pc++);
-            CPush(i, i->fp[(int)tmpb]);
-            break;
-        case OP_LSET:
-            tmpb = (int8_t)VMCODEBYTE(i->pc++);
-            i->fp[(int)tmpb] = Pop(i);
-            break;
-        case OP_VREF:
-            ind = *i->sp;
-            obj = *i->hsp;
-            if (ind < 0 || ind >= GetHeapObjSize(obj))
-                Abort(i->sys, str_subscript_err, ind);
-            *i->sp = GetIntegerVectorBase(obj)[ind];
-            DropH(i, 1);
-            break;
-        case OP_VSET:
-            tmp2 = Pop(i);
-            ind = Pop(i);
-            obj = *i->hsp;
-            if (ind < 0 || ind >= GetHeapObjSize(obj))
-                Abort(i->sys, str_subscript_err, ind);
-            GetIntegerVectorBase(obj)[ind] = tmp2;
-            DropH(i, 1);
-            break;
-       case OP_LITH:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            CPushH(i, (VMHANDLE)tmp);
-            ObjAddRef(*i->hsp);
-            break;
-        case OP_GREFH:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            CPushH(i, GetSymbolPtr((VMHANDLE)tmp)->v.hValue);
-            ObjAddRef(*i->hsp);
-            break;
-        case OP_GSETH:
-            get_VMVALUE(tmp, VMCODEBYTE(i->pc++));
-            ObjRelease(i->heap, GetSymbolPtr((VMHANDLE)tmp)->v.hValue);
-            GetSymbolPtr((VMHANDLE)tmp)->v.hValue = PopH(i);
-            break;
-        case OP_LREFH:
-            tmpb = (int8_t)VMCODEBYTE(i->pc++);
-            CPushH(i, i->hfp[(int)tmpb]);
-            ObjAddRef(*i->hsp);
-            break;
-        case OP_LSETH:
-            tmpb = (int8_t)VMCODEBYTE(i->pc++);
-            ObjRelease(i->heap, i->hfp[(int)tmpb]);
-            i->hfp[(int)tmpb] = PopH(i);
-            break;
-        case OP_VREFH:
-            ind = Pop(i);
-            obj = *i->hsp;
-            if (ind < 0 || ind >= GetHeapObjSize(obj))
-                Abort(i->sys, str_subscript_err, ind);
-            *i->hsp = GetStringVectorBase(obj)[ind];
-            ObjAddRef(*i->hsp);
-            break;
-        case OP_VSETH:
-            htmp = PopH(i);
-            ind = Pop(i);
-            obj = *i->hsp;
-            if (ind < 0 || ind >= GetHeapObjSize(obj))
-                Abort(i->sys, str_subscript_err, ind);
-            ObjRelease(i->heap, GetStringVectorBase(obj)[ind]);
-            GetStringVectorBase(obj)[ind] = htmp;
-            DropH(i, 1);
-            break;
-        case OP_RESERVE:
-            tmp = VMCODEBYTE(i->pc++);
-            tmp2 = VMCODEBYTE(i->pc++);
-            Reserve(i, tmp);
-            ReserveH(i, tmp2);
-            break;
-         case OP_CALL:
-            StartCode(i);
-            break;
-        case OP_RETURN:
-            tmp = *i->sp;
-            PopFrame(i);
-            Push(i, tmp);
-            break;
-        case OP_RETURNH:
-            htmp = *i->hsp;
-            PopFrame(i);
-            PushH(i, htmp);
-            break;
-        case OP_RETURNV:
-            PopFrame(i);
-            break;
-        case OP_DROP:
-            Drop(i, 1);
-            break;
-        case OP_DROPH:
-            ObjRelease(i->heap, *i->hsp);
-            DropH(i, 1);
-            break;
-        default:
-            Abort(i->sys, str_opcode_err, VMCODEBYTE(i->pc - 1));
-            break;
-        }
-    }
-}
-
-static void StartCode(Interpreter *i)
-{
-    VMHANDLE code = PopH(i);
-    VMVALUE tmp, tmp2;
-
-    if (!code)
-        Abort(i->sys, str_not_code_object_err, code);
-        
-    switch (GetHeapObjType(code)) {
-    case ObjTypeCode:
-        tmp = (VMVALUE)(i->fp - i->stack);
-        tmp2 = (VMVALUE)(i->hfp - (VMHANDLE *)i->stack);
-        i->hfp = i->hsp;
-        PushH(i, i->code);
-        i->fp = i->sp;
-        Reserve(i, F_SIZE);
-        i->fp[F_FP] = tmp;
-        i->fp[F_HFP] = tmp2;
-        i->fp[F_PC] = (VMVALUE)(i->pc - i->cbase);
-        i->code = code;
-        ObjAddRef(i->code);
-        i->cbase = i->pc = GetCodePtr(code);
-        break;
-    case ObjTypeIntrinsic:
-        (*GetIntrinsicHandler(code))(i);
-        break;
-    default:
-        Abort(i->sys, str_not_code_object_err, code);
-        break;
-    }
-}
-
-static void PopFrame(Interpreter *i)
-{
-    int argumentCount = VMCODEBYTE(i->pc++);
-    int handleArgumentCount = VMCODEBYTE(i->pc++);
-    ObjRelease(i->heap, i->code);
-    i->code = i->hfp[HF_CODE];
-    i->hsp = i->hfp;
-    while (--handleArgumentCount >= 0) {
-        ObjRelease(i->heap, *i->hsp);
-        DropH(i, 1);
-    }
-    i->cbase = GetCodePtr(i->code);
-    i->pc = i->cbase + i->fp[F_PC];
-    i->hfp = (VMHANDLE *)i->stack + i->fp[F_HFP];
-    i->sp = i->fp;
-    i->fp = i->stack + i->fp[F_FP];
-    Drop(i, argumentCount);
-}
-
-static void StringCat(Interpreter *i)
-{
-    VMHANDLE hStr2 = PopH(i);
-    VMHANDLE hStr1 = *i->hsp;
-    uint8_t *str1, *str2, *str;
-    size_t len1, len2;
-
-    /* get the first string pointer and length */
-    str1 = GetStringPtr(hStr1);
-    len1 = GetHeapObjSize(hStr1);
-
-    /* get the second string pointer and length */
-    str2 = GetStringPtr(hStr2);
-    len2 = GetHeapObjSize(hStr2);
-
-    /* allocate the result string */
-    if (!(*i->hsp = NewString(i->heap, len1 + len2)))
-        Abort(i->sys, "insufficient memory");
-    str = GetStringPtr(*i->hsp);
-
-    /* copy the source strings into the result string */
-    memcpy(str, str1, len1);
-    memcpy(str + len1, str2, len2);
-    
-    /* release the two argument strings */
-    ObjRelease(i->heap, hStr1);
-    ObjRelease(i->heap, hStr2);
-}
-
-void ShowStack(Interpreter *i)
-{
-    VMHANDLE *hp;
-    VMVALUE *p;
-    
-    for (hp = (VMHANDLE *)i->stack; hp <= i->hsp; ++hp) {
-        if (hp == i->hfp)
-            VM_printf(str_hfp_tag);
-        VM_printf(str_hstack_entry_fmt, (VMUVALUE)*hp);
-    }
-    
-    VM_printf(str_stack_separator);
-    
-    for (p = i->sp; p < i->stackTop; ++p) {
-        if (p == i->fp)
-            VM_printf(str_fp_tag);
-        VM_printf(str_stack_entry, *p);
-    }
-    
-    VM_putchar('\n');
-}
-
-void StackOverflow(Interpreter *i)
-{
-    Abort(i->sys, str_stack_overflow_err);
-}
-
-/* AfterCompact - called after the heap manager compacts the heap */
-static void AfterCompact(void *cookie)
-{
-    Interpreter *i = (Interpreter *)cookie;
-    uint8_t *cbase = GetCodePtr(i->code);
-    i->pc = cbase + (i->pc - i->cbase);
-    i->cbase = cbase;
-}
-
-FLASH_SPACE char str_subscript_err[]        = "subscript out of bounds: %d";
-FLASH_SPACE char str_stack_overflow_err[]   = "stack overflow";
-FLASH_SPACE char str_not_code_object_err[]  = "not code object: %d";
-FLASH_SPACE char str_opcode_err[]           = "undefined opcode 0x%02x";
-FLASH_SPACE char str_value_fmt[]            = "%d";
-FLASH_SPACE char str_hfp_tag[]              = " <hfp>";
-FLASH_SPACE char str_hstack_entry_fmt[]     = " %08x";
-FLASH_SPACE char str_stack_separator[]      = " ---";
-FLASH_SPACE char str_fp_tag[]               = " <fp>";
-FLASH_SPACE char str_stack_entry[]          = " %d";
+/* db_vmint.c - bytecode interpreter for a simple virtual machine
+ *
+ * Copyright (c) 2009-2012 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include "db_vm.h"
+
+/* instruction fetch and operand decoding
+ *
+ * Normally the interpreter runs the packed bytecode directly. With PREDECODE
+ * defined it runs the pre-decoded form built by DecodeAllCode instead where
+ * each instruction has its operand already assembled and branch operands are
+ * absolute instruction indexes.
+ */
+#ifdef PREDECODE
+#define NextOpcode()    ((pc++)->op.opcode)
+#define NextHandler()   ((pc++)->op.handler)
+#define GetValue(v)     ((v) = pc[-1].operand)
+#define GetOffset(v)    ((v) = pc[-1].operand)
+#define GetNextValue(v) ((v) = (pc++)->operand)
+#define GetNextOffset(v) ((v) = (pc++)->operand)
+#define Branch(t)       (pc = i->cbase + (t))
+#define IsBackward(t)   (i->cbase + (t) < pc)
+#define BadOpcode()     (pc[-1].operand)
+#else
+#define NextOpcode()    VMCODEBYTE(pc++)
+#define NextHandler()   dispatch[VMCODEBYTE(pc++)]
+#define GetValue(v)     do { get_VMVALUE(v, VMCODEBYTE(pc++)) } while (0)
+#define GetOffset(v)    ((v) = (int8_t)VMCODEBYTE(pc++))
+#define GetNextValue(v) GetValue(v)
+#define GetNextOffset(v) GetOffset(v)
+#define Branch(t)       (pc += (t))
+#define IsBackward(t)   ((t) < 0)
+#define BadOpcode()     VMCODEBYTE(pc - 1)
+#endif
+
+/* register code operands
+ *
+ * With REGISTER_VM defined the pre-decoded code is register code built by
+ * TranslateCode. Its operands are locals, globals, temporaries just below
+ * sp or immediate values. The cached top of stack would hide the stack
+ * temporaries so TOS_CACHE can't be used with it.
+ */
+#ifdef REGISTER_VM
+#ifndef PREDECODE
+#error REGISTER_VM requires PREDECODE
+#endif
+#ifdef TOS_CACHE
+#error REGISTER_VM is incompatible with TOS_CACHE
+#endif
+#define RegAddr(o)      (((o) & 3) == R_GLOBAL                                      \
+                        ? &GetSymbolPtr(ValueToHandle((o) & ~3))->v.iValue          \
+                        : ((o) & 2 ? sp : fp) + ((o) >> 2))
+#define RegValue(o)     ((o) & 3 ? *RegAddr(o) : (o) >> 2)
+#endif
+
+/* instruction dispatch
+ *
+ * The default is a single switch statement which works with any C compiler.
+ * Defining DIRECT_THREADED uses the GCC "labels as values" extension instead
+ * so that each opcode handler ends with its own indirect jump to the next
+ * handler. This gives the branch predictor one jump site per opcode rather
+ * than a single shared one.
+ */
+#ifdef DIRECT_THREADED
+#ifndef __GNUC__
+#error DIRECT_THREADED requires the GCC labels-as-values extension
+#endif
+#define DISPATCH()      goto *NextHandler();
+#define OPCODE(op)      L_##op
+#define DEFAULT         L_default
+#define NEXT            goto *NextHandler()
+#else
+#define DISPATCH()      switch (NextOpcode())
+#define OPCODE(op)      case op
+#define DEFAULT         default
+#define NEXT            break
+#endif
+
+/* interpreter registers
+ *
+ * The interpreter loop keeps pc, sp and fp in local variables so they must be
+ * written back before calling anything that uses or updates them and before
+ * reporting an error. Defining TOS_CACHE also keeps the value on the top of
+ * the stack in a local variable. In that case sp points to the value below
+ * it and SaveState spills it back onto the stack. Frames reserve a spare word
+ * below their locals so the cached value is never a copy of a local.
+ *
+ * Pushes aren't checked for stack overflow. StartCode checks once per call
+ * that there is room for the most the called code can push.
+ */
+#ifdef TOS_CACHE
+#define TOS             tos
+#define DropTOS()       (tos = *sp++)
+#define PushTOS(v)      (*--sp = tos, tos = (v))
+#define SaveState(i)    ((i)->pc = pc, *--sp = tos, (i)->sp = sp, (i)->fp = fp)
+#define RestoreState(i) (pc = (i)->pc, sp = (i)->sp, fp = (i)->fp, tos = *sp++)
+#define TOS_SPARE       1
+#else
+#define TOS             (*sp)
+#define DropTOS()       (++sp)
+#define PushTOS(v)      (*--sp = (v))
+#define SaveState(i)    ((i)->pc = pc, (i)->sp = sp, (i)->fp = fp)
+#define RestoreState(i) (pc = (i)->pc, sp = (i)->sp, fp = (i)->fp)
+#define TOS_SPARE       0
+#endif
+#define PopTOS(v)       ((v) = TOS, DropTOS())
+
+/* returning to native code
+ *
+ * With JIT defined a function called from native code runs in a nested
+ * interpreter loop. Its frame has NATIVE_PC as the return address and the
+ * loop returns to CallFromNative when that frame is popped.
+ */
+#ifdef JIT
+#define CheckNativeCaller() (ind = (fp[F_PC] == NATIVE_PC))
+#define ReturnToNative()    do {                                        \
+                                if (ind) {                              \
+                                    SaveState(i);                       \
+                                    return VMTRUE;                      \
+                                }                                       \
+                            } while (0)
+#else
+#define CheckNativeCaller()
+#define ReturnToNative()
+#endif
+
+/* compacting the heap on backward branches
+ *
+ * With COMPACT_ON_LOOPS defined each backward branch taken while a heap
+ * compaction cycle is in progress does a step of it so the cycle finishes
+ * even in loops that don't allocate. AfterCompact moves pc along with the
+ * code.
+ */
+#ifdef COMPACT_ON_LOOPS
+#define LoopCompact()   do {                                            \
+                            if (i->heap->compactScan) {                 \
+                                SaveState(i);                           \
+                                CompactHeapStep(i->heap, COMPACT_STEP); \
+                                RestoreState(i);                        \
+                            }                                           \
+                        } while (0)
+#else
+#define LoopCompact()
+#endif
+
+/* counting backward branches
+ *
+ * With JIT defined each backward branch taken counts towards compiling the
+ * function. When the count reaches the loop threshold the loop carries on
+ * in native code if it can. EnterNativeLoop returns VMTRUE if the interpreter
+ * loop has nothing left to do after that.
+ */
+#ifdef JIT
+#define LoopBranch(t)   do {                                            \
+                            Branch(t);                                  \
+                            LoopCompact();                              \
+                            if (++GetCodeTier(i, i->code)->backEdges == i->loopThreshold) { \
+                                SaveState(i);                           \
+                                if (EnterNativeLoop(i))                 \
+                                    return VMTRUE;                      \
+                                RestoreState(i);                        \
+                            }                                           \
+                        } while (0)
+#else
+#define LoopBranch(t)   do {                                            \
+                            Branch(t);                                  \
+                            LoopCompact();                              \
+                        } while (0)
+#endif
+
+/* handler bodies for the compare and branch superinstructions */
+#define CompareAndBranch(op)        do {                                \
+                                        GetValue(tmp);                  \
+                                        PopTOS(tmp2);                   \
+                                        PopTOS(ind);                    \
+                                        if (ind op tmp2)                \
+                                            Branch(tmp);                \
+                                    } while (0)
+#define LocalCompareAndBranch(op)   do {                                \
+                                        GetOffset(tmpb);                \
+                                        GetNextValue(tmp2);             \
+                                        GetNextValue(tmp);              \
+                                        if (fp[(int)tmpb] op tmp2)      \
+                                            Branch(tmp);                \
+                                    } while (0)
+#define RegisterCompareAndBranch(op)    do {                            \
+                                        GetValue(tmp);                  \
+                                        GetNextValue(tmp2);             \
+                                        GetNextValue(ind);              \
+                                        if (RegValue(tmp) op RegValue(tmp2)) \
+                                            Branch(ind);                \
+                                    } while (0)
+
+/* handler bodies for the register code operators */
+#define RegisterUnary(expr)         do {                                \
+                                        GetValue(tmp);                  \
+                                        GetNextValue(tmp2);             \
+                                        tmp2 = RegValue(tmp2);          \
+                                        *RegAddr(tmp) = (expr);         \
+                                    } while (0)
+#define RegisterBinary(expr)        do {                                \
+                                        GetValue(ind);                  \
+                                        GetNextValue(tmp);              \
+                                        GetNextValue(tmp2);             \
+                                        tmp = RegValue(tmp);            \
+                                        tmp2 = RegValue(tmp2);          \
+                                        *RegAddr(ind) = (expr);         \
+                                    } while (0)
+
+/* handler bodies for the FOR loop opcodes
+ *
+ * These expect vptr to point to the control variable. The limit is kept in
+ * the frame at the slot offset and the step just below it. The direction of
+ * the limit test depends on the sign of the step.
+ */
+#define ForLoop()                   do {                                \
+                                        GetNextOffset(tmpb);            \
+                                        GetNextValue(tmp);              \
+                                        PopTOS(tmp2);                   \
+                                        fp[tmpb - 1] = tmp2;            \
+                                        PopTOS(fp[(int)tmpb]);          \
+                                        if (tmp2 >= 0 ? *vptr > fp[(int)tmpb] : *vptr < fp[(int)tmpb]) \
+                                            Branch(tmp);                \
+                                    } while (0)
+#define NextLoop()                  do {                                \
+                                        GetNextOffset(tmpb);            \
+                                        GetNextValue(tmp);              \
+                                        tmp2 = fp[tmpb - 1];            \
+                                        *vptr += tmp2;                  \
+                                        if (tmp2 >= 0 ? *vptr <= fp[(int)tmpb] : *vptr >= fp[(int)tmpb]) \
+                                            LoopBranch(tmp);            \
+                                    } while (0)
+
+/* prototypes for local functions */
+static int ExecuteLoop(Interpreter *i);
+static void StartCode(Interpreter *i);
+static void TailCall(Interpreter *i);
+static void PopFrame(Interpreter *i);
+static void CheckStack(Interpreter *i, uint8_t *p, int frame, int hframe);
+static void AfterCompact(void *cookie);
+#ifdef PREDECODE
+static int DecodeAllCode(Interpreter *i);
+#ifndef REGISTER_VM
+static Instr *DecodeCode(Interpreter *i, VMHANDLE code);
+static int DecodedSize(int opcode);
+#endif
+#define GetCodeBase(i, h)   ((i)->decoded[(h) - (i)->heap->handles])
+#define ENTRY_OFFSET        1
+#define GetArgumentCounts(i, a, b)  ((a) = (i)->cbase->operand & 0xff, (b) = ((i)->cbase->operand >> 8) & 0xff)
+#else
+#define GetCodeBase(i, h)   GetCodePtr(h)
+#define ENTRY_OFFSET        FD_SIZE
+#define GetArgumentCounts(i, a, b)  ((a) = VMCODEBYTE((i)->cbase + FD_ARGS), (b) = VMCODEBYTE((i)->cbase + FD_HARGS))
+#endif
+
+/* entering code
+ *
+ * The locals described by the frame descriptor at p are reserved along with
+ * the TOS_SPARE word and the code starts after the descriptor. Pre-decoded
+ * code has the descriptor as its first entry with the argument counts that
+ * PopFrame needs in its operand.
+ */
+#define EnterCode(i, h, p)  do {                                        \
+                                int cnt = VMCODEBYTE((p) + FD_LOCALS) + TOS_SPARE; \
+                                int hcnt = VMCODEBYTE((p) + FD_HLOCALS); \
+                                while (--cnt >= 0)                      \
+                                    Push(i, 0);                         \
+                                while (--hcnt >= 0)                     \
+                                    PushH(i, NULL);                     \
+                                (i)->code = (h);                        \
+                                (i)->cbase = GetCodeBase(i, h);         \
+                                (i)->pc = (i)->cbase + ENTRY_OFFSET;    \
+                            } while (0)
+
+#ifdef JIT
+static int EnterNativeLoop(Interpreter *i);
+static VMVALUE BytecodeOffset(Interpreter *i);
+#define GetCodeTier(i, h)   (&(i)->tiers[(h) - (i)->heap->handles])
+#define GetNativeCode(i, h) (GetCodeTier(i, h)->native)
+#define GetHotCode(i, h)    (GetNativeCode(i, h) ? GetNativeCode(i, h)     \
+                            : ++GetCodeTier(i, h)->calls == (i)->callThreshold \
+                            ? CompileHotCode(i, h, TIER_CALLS) : NULL)
+#endif
+
+/* Execute - execute the main code */
+int Execute(System *sys, ObjHeap *heap, VMHANDLE main)
+{
+    size_t stackSize;
+    Interpreter *i;
+#ifdef JIT
+    NativeCode *native;
+#endif
+
+    /* allocate the interpreter state */
+    if (!(i = (Interpreter *)AllocateFreeSpace(sys, sizeof(Interpreter))))
+        return VMFALSE;
+
+    /* initialize the interpreter state */
+    i->sys = sys;
+    i->heap = heap;
+
+#ifdef PREDECODE
+    /* translate the code objects into pre-decoded instructions */
+    if (!DecodeAllCode(i))
+        return VMFALSE;
+#endif
+
+#ifdef JIT
+    /* setup to compile hot code objects into native code */
+    if (!InitTiers(i))
+        return VMFALSE;
+#endif
+
+    /* make sure there is space left for the stack */
+    if ((stackSize = (sys->freeTop - sys->freeNext) / sizeof(VMVALUE)) <= F_SIZE)
+        return VMFALSE;
+        
+    /* setup the heap before/after compact functions */
+    heap->beforeCompact = NULL;
+    heap->afterCompact = AfterCompact;
+    heap->compactCookie = i;
+    
+    /* setup the stack in the remaining free space */
+    i->stack = (VMVALUE *)sys->freeNext;
+    i->stackTop = i->stack + stackSize;
+    
+    /* give the main code an empty frame so its locals are addressed like function locals */
+    i->fp = i->stackTop;
+    i->sp = i->fp - F_SIZE;
+    memset(i->sp, 0, F_SIZE * sizeof(VMVALUE));
+    i->hsp = i->hfp = (VMHANDLE *)i->stack - 1;
+
+    if (setjmp(i->sys->errorTarget)) {
+        while (i->hsp > (VMHANDLE *)i->stack)
+            ObjRelease(i->heap, PopH(i));
+        return VMFALSE;
+    }
+
+    /* the main code frame is already there but what the code pushes still has to fit */
+    CheckStack(i, GetCodePtr(main), 0, 0);
+    EnterCode(i, main, GetCodePtr(main));
+
+#ifdef JIT
+    /* run the main code natively if it is compiled */
+    if ((native = GetHotCode(i, main)) != NULL) {
+        (*native)(i);
+        return VMTRUE;
+    }
+#endif
+
+    /* execute the main code */
+    return ExecuteLoop(i);
+}
+
+/* ExecuteLoop - the bytecode interpreter loop
+ *
+ * This is kept separate from Execute so that the setjmp there doesn't force
+ * the compiler to keep the interpreter state pointer in memory.
+ */
+static int ExecuteLoop(Interpreter *i)
+{
+    VMVALUE tmp, tmp2, ind, *vptr;
+    VMHANDLE obj, htmp;
+    int8_t tmpb;
+    VMVALUE *sp, *fp;
+    VMCODE *pc;
+#ifdef TOS_CACHE
+    VMVALUE tos;
+#endif
+#ifdef DIRECT_THREADED
+    static void *dispatch[256] = {
+        [0 ... 255]     = &&DEFAULT,
+        [OP_HALT]       = &&OPCODE(OP_HALT),
+        [OP_BRT]        = &&OPCODE(OP_BRT),
+        [OP_BRTSC]      = &&OPCODE(OP_BRTSC),
+        [OP_BRF]        = &&OPCODE(OP_BRF),
+        [OP_BRFSC]      = &&OPCODE(OP_BRFSC),
+        [OP_BR]         = &&OPCODE(OP_BR),
+        [OP_NOT]        = &&OPCODE(OP_NOT),
+        [OP_NEG]        = &&OPCODE(OP_NEG),
+        [OP_ADD]        = &&OPCODE(OP_ADD),
+        [OP_SUB]        = &&OPCODE(OP_SUB),
+        [OP_MUL]        = &&OPCODE(OP_MUL),
+        [OP_DIV]        = &&OPCODE(OP_DIV),
+        [OP_REM]        = &&OPCODE(OP_REM),
+        [OP_BNOT]       = &&OPCODE(OP_BNOT),
+        [OP_BAND]       = &&OPCODE(OP_BAND),
+        [OP_BOR]        = &&OPCODE(OP_BOR),
+        [OP_BXOR]       = &&OPCODE(OP_BXOR),
+        [OP_SHL]        = &&OPCODE(OP_SHL),
+        [OP_SHR]        = &&OPCODE(OP_SHR),
+        [OP_LT]         = &&OPCODE(OP_LT),
+        [OP_LE]         = &&OPCODE(OP_LE),
+        [OP_EQ]         = &&OPCODE(OP_EQ),
+        [OP_NE]         = &&OPCODE(OP_NE),
+        [OP_GE]         = &&OPCODE(OP_GE),
+        [OP_GT]         = &&OPCODE(OP_GT),
+        [OP_LIT]        = &&OPCODE(OP_LIT),
+        [OP_GREF]       = &&OPCODE(OP_GREF),
+        [OP_GSET]       = &&OPCODE(OP_GSET),
+        [OP_LREF]       = &&OPCODE(OP_LREF),
+        [OP_LSET]       = &&OPCODE(OP_LSET),
+        [OP_VREF]       = &&OPCODE(OP_VREF),
+        [OP_VSET]       = &&OPCODE(OP_VSET),
+        [OP_CALL]       = &&OPCODE(OP_CALL),
+        [OP_RETURN]     = &&OPCODE(OP_RETURN),
+        [OP_RETURNV]    = &&OPCODE(OP_RETURNV),
+        [OP_DROP]       = &&OPCODE(OP_DROP),
+        [OP_ADDI]       = &&OPCODE(OP_ADDI),
+        [OP_LINC]       = &&OPCODE(OP_LINC),
+        [OP_LREF2]      = &&OPCODE(OP_LREF2),
+        [OP_BRLT]       = &&OPCODE(OP_BRLT),
+        [OP_BRLE]       = &&OPCODE(OP_BRLE),
+        [OP_BREQ]       = &&OPCODE(OP_BREQ),
+        [OP_BRNE]       = &&OPCODE(OP_BRNE),
+        [OP_BRGE]       = &&OPCODE(OP_BRGE),
+        [OP_BRGT]       = &&OPCODE(OP_BRGT),
+        [OP_LBRLT]      = &&OPCODE(OP_LBRLT),
+        [OP_LBRLE]      = &&OPCODE(OP_LBRLE),
+        [OP_LBREQ]      = &&OPCODE(OP_LBREQ),
+        [OP_LBRNE]      = &&OPCODE(OP_LBRNE),
+        [OP_LBRGE]      = &&OPCODE(OP_LBRGE),
+        [OP_LBRGT]      = &&OPCODE(OP_LBRGT),
+        [OP_FORL]       = &&OPCODE(OP_FORL),
+        [OP_NEXTL]      = &&OPCODE(OP_NEXTL),
+        [OP_FORG]       = &&OPCODE(OP_FORG),
+        [OP_NEXTG]      = &&OPCODE(OP_NEXTG),
+        [OP_VREFU]      = &&OPCODE(OP_VREFU),
+        [OP_VSETU]      = &&OPCODE(OP_VSETU),
+        [OP_CALLI]      = &&OPCODE(OP_CALLI),
+        [OP_TCALL]      = &&OPCODE(OP_TCALL),
+        [OP_LTEE]       = &&OPCODE(OP_LTEE),
+        [OP_LITH]       = &&OPCODE(OP_LITH),
+        [OP_GREFH]      = &&OPCODE(OP_GREFH),
+        [OP_GSETH]      = &&OPCODE(OP_GSETH),
+        [OP_GAPPH]      = &&OPCODE(OP_GAPPH),
+        [OP_LREFH]      = &&OPCODE(OP_LREFH),
+        [OP_LSETH]      = &&OPCODE(OP_LSETH),
+        [OP_LAPPH]      = &&OPCODE(OP_LAPPH),
+        [OP_VREFH]      = &&OPCODE(OP_VREFH),
+        [OP_VSETH]      = &&OPCODE(OP_VSETH),
+        [OP_RETURNH]    = &&OPCODE(OP_RETURNH),
+        [OP_DROPH]      = &&OPCODE(OP_DROPH),
+        [OP_CAT]        = &&OPCODE(OP_CAT),
+        [OP_CATN]       = &&OPCODE(OP_CATN),
+        [OP_SCMP]       = &&OPCODE(OP_SCMP),
+#ifdef REGISTER_VM
+        [R_NOT]         = &&OPCODE(R_NOT),
+        [R_NEG]         = &&OPCODE(R_NEG),
+        [R_ADD]         = &&OPCODE(R_ADD),
+        [R_SUB]         = &&OPCODE(R_SUB),
+        [R_MUL]         = &&OPCODE(R_MUL),
+        [R_DIV]         = &&OPCODE(R_DIV),
+        [R_REM]         = &&OPCODE(R_REM),
+        [R_BNOT]        = &&OPCODE(R_BNOT),
+        [R_BAND]        = &&OPCODE(R_BAND),
+        [R_BOR]         = &&OPCODE(R_BOR),
+        [R_BXOR]        = &&OPCODE(R_BXOR),
+        [R_SHL]         = &&OPCODE(R_SHL),
+        [R_SHR]         = &&OPCODE(R_SHR),
+        [R_LT]          = &&OPCODE(R_LT),
+        [R_LE]          = &&OPCODE(R_LE),
+        [R_EQ]          = &&OPCODE(R_EQ),
+        [R_NE]          = &&OPCODE(R_NE),
+        [R_GE]          = &&OPCODE(R_GE),
+        [R_GT]          = &&OPCODE(R_GT),
+        [R_MOV]         = &&OPCODE(R_MOV),
+        [R_LI]          = &&OPCODE(R_LI),
+        [R_BRT]         = &&OPCODE(R_BRT),
+        [R_BRF]         = &&OPCODE(R_BRF),
+        [R_BRLT]        = &&OPCODE(R_BRLT),
+        [R_BRLE]        = &&OPCODE(R_BRLE),
+        [R_BREQ]        = &&OPCODE(R_BREQ),
+        [R_BRNE]        = &&OPCODE(R_BRNE),
+        [R_BRGE]        = &&OPCODE(R_BRGE),
+        [R_BRGT]        = &&OPCODE(R_BRGT),
+        [R_ADJSP]       = &&OPCODE(R_ADJSP),
+#endif
+    };
+#ifdef PREDECODE
+    Instr *ip;
+
+    /* replace the pre-decoded opcodes with the addresses of their handlers */
+    for (ip = i->decodedBase; ip < i->decodedTop; ++ip)
+        ip->op.handler = dispatch[ip->op.opcode];
+        
+    /* only do that once if the loop is reentered */
+    i->decodedTop = i->decodedBase;
+#endif
+#endif
+
+    /* load the interpreter registers */
+    RestoreState(i);
+
+    for (;;) {
+#if 0
+        SaveState(i);
+        ShowStack(i);
+        RestoreState(i);
+        DecodeInstruction(0, 0, pc);
+#endif
+        DISPATCH() {
+        OPCODE(OP_HALT):
+            return VMTRUE;
+        OPCODE(OP_BRT):
+            GetValue(tmp);
+            PopTOS(tmp2);
+            if (tmp2)
+                Branch(tmp);
+            NEXT;
+        OPCODE(OP_BRTSC):
+            GetValue(tmp);
+            if (TOS)
+                Branch(tmp);
+            else
+                DropTOS();
+            NEXT;
+        OPCODE(OP_BRF):
+            GetValue(tmp);
+            PopTOS(tmp2);
+            if (!tmp2)
+                Branch(tmp);
+            NEXT;
+        OPCODE(OP_BRFSC):
+            GetValue(tmp);
+            if (!TOS)
+                Branch(tmp);
+            else
+                DropTOS();
+            NEXT;
+        OPCODE(OP_BR):
+            GetValue(tmp);
+#ifdef JIT
+            if (IsBackward(tmp)) {
+                LoopBranch(tmp);
+                NEXT;
+            }
+#endif
+            Branch(tmp);
+            NEXT;
+        OPCODE(OP_NOT):
+            TOS = (TOS ? VMFALSE : VMTRUE);
+            NEXT;
+        OPCODE(OP_NEG):
+            TOS = -TOS;
+            NEXT;
+        OPCODE(OP_ADD):
+            PopTOS(tmp);
+            TOS += tmp;
+            NEXT;
+        OPCODE(OP_SUB):
+            PopTOS(tmp);
+            TOS -= tmp;
+            NEXT;
+        OPCODE(OP_MUL):
+            PopTOS(tmp);
+            TOS *= tmp;
+            NEXT;
+        OPCODE(OP_DIV):
+            PopTOS(tmp);
+            TOS = (tmp == 0 ? 0 : TOS / tmp);
+            NEXT;
+        OPCODE(OP_REM):
+            PopTOS(tmp);
+            TOS = (tmp == 0 ? 0 : TOS % tmp);
+            NEXT;
+        OPCODE(OP_CAT):
+            SaveState(i);
+            StringCat(i, 2);
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_CATN):
+            GetOffset(tmpb);
+            SaveState(i);
+            StringCat(i, tmpb);
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_SCMP):
+            GetOffset(tmpb);
+            SaveState(i);
+            StringCompare(i, tmpb);
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_BNOT):
+            TOS = ~TOS;
+            NEXT;
+        OPCODE(OP_BAND):
+            PopTOS(tmp);
+            TOS &= tmp;
+            NEXT;
+        OPCODE(OP_BOR):
+            PopTOS(tmp);
+            TOS |= tmp;
+            NEXT;
+        OPCODE(OP_BXOR):
+            PopTOS(tmp);
+            TOS ^= tmp;
+            NEXT;
+        OPCODE(OP_SHL):
+            PopTOS(tmp);
+            TOS <<= tmp;
+            NEXT;
+        OPCODE(OP_SHR):
+            PopTOS(tmp);
+            TOS >>= tmp;
+            NEXT;
+        OPCODE(OP_LT):
+            PopTOS(tmp);
+            TOS = (TOS < tmp ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(OP_LE):
+            PopTOS(tmp);
+            TOS = (TOS <= tmp ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(OP_EQ):
+            PopTOS(tmp);
+            TOS = (TOS == tmp ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(OP_NE):
+            PopTOS(tmp);
+            TOS = (TOS != tmp ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(OP_GE):
+            PopTOS(tmp);
+            TOS = (TOS >= tmp ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(OP_GT):
+            PopTOS(tmp);
+            TOS = (TOS > tmp ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(OP_LIT):
+            GetValue(tmp);
+            PushTOS(tmp);
+            NEXT;
+        OPCODE(OP_GREF):
+            GetValue(tmp);
+            obj = ValueToHandle(tmp);
+            PushTOS(GetSymbolPtr(obj)->v.iValue);
+            NEXT;
+        OPCODE(OP_GSET):
+            GetValue(tmp);
+            obj = ValueToHandle(tmp);
+            PopTOS(GetSymbolPtr(obj)->v.iValue);
+            NEXT;
+        OPCODE(OP_LREF):
+            GetOffset(tmpb);
+            PushTOS(fp[(int)tmpb]);
+            NEXT;
+        OPCODE(OP_LSET):
+            GetOffset(tmpb);
+            PopTOS(fp[(int)tmpb]);
+            NEXT;
+        OPCODE(OP_LTEE):
+            GetOffset(tmpb);
+            fp[(int)tmpb] = TOS;
+            NEXT;
+        OPCODE(OP_VREF):
+            ind = TOS;
+            obj = *i->hsp;
+            if (ind < 0 || ind >= GetHeapObjSize(obj)) {
+                SaveState(i);
+                Abort(i->sys, str_subscript_err, ind);
+            }
+            TOS = GetIntegerVectorBase(obj)[ind];
+            DropH(i, 1);
+            NEXT;
+        OPCODE(OP_VSET):
+            PopTOS(tmp2);
+            PopTOS(ind);
+            obj = *i->hsp;
+            if (ind < 0 || ind >= GetHeapObjSize(obj)) {
+                SaveState(i);
+                Abort(i->sys, str_subscript_err, ind);
+            }
+            GetIntegerVectorBase(obj)[ind] = tmp2;
+            DropH(i, 1);
+            NEXT;
+        OPCODE(OP_VREFU):
+            TOS = GetIntegerVectorBase(*i->hsp)[TOS];
+            DropH(i, 1);
+            NEXT;
+        OPCODE(OP_VSETU):
+            PopTOS(tmp2);
+            PopTOS(ind);
+            GetIntegerVectorBase(*i->hsp)[ind] = tmp2;
+            DropH(i, 1);
+            NEXT;
+        OPCODE(OP_LITH):
+            GetValue(tmp);
+            PushH(i, ValueToHandle(tmp));
+            ObjAddRef(*i->hsp);
+            NEXT;
+        OPCODE(OP_GREFH):
+            GetValue(tmp);
+            PushH(i, GetSymbolPtr(ValueToHandle(tmp))->v.hValue);
+            ObjAddRef(*i->hsp);
+            NEXT;
+        OPCODE(OP_GSETH):
+            GetValue(tmp);
+            ObjRelease(i->heap, GetSymbolPtr(ValueToHandle(tmp))->v.hValue);
+            GetSymbolPtr(ValueToHandle(tmp))->v.hValue = PopH(i);
+            NEXT;
+        OPCODE(OP_GAPPH):
+            GetValue(tmp);
+            SaveState(i);
+            obj = StringAppend(i, GetSymbolPtr(ValueToHandle(tmp))->v.hValue);
+            GetSymbolPtr(ValueToHandle(tmp))->v.hValue = obj;
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_LREFH):
+            GetOffset(tmpb);
+            PushH(i, i->hfp[(int)tmpb]);
+            ObjAddRef(*i->hsp);
+            NEXT;
+        OPCODE(OP_LSETH):
+            GetOffset(tmpb);
+            ObjRelease(i->heap, i->hfp[(int)tmpb]);
+            i->hfp[(int)tmpb] = PopH(i);
+            NEXT;
+        OPCODE(OP_LAPPH):
+            GetOffset(tmpb);
+            SaveState(i);
+            i->hfp[(int)tmpb] = StringAppend(i, i->hfp[(int)tmpb]);
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_VREFH):
+            PopTOS(ind);
+            obj = *i->hsp;
+            if (ind < 0 || ind >= GetHeapObjSize(obj)) {
+                SaveState(i);
+                Abort(i->sys, str_subscript_err, ind);
+            }
+            *i->hsp = GetStringVectorBase(obj)[ind];
+            ObjAddRef(*i->hsp);
+            NEXT;
+        OPCODE(OP_VSETH):
+            htmp = PopH(i);
+            PopTOS(ind);
+            obj = *i->hsp;
+            if (ind < 0 || ind >= GetHeapObjSize(obj)) {
+                SaveState(i);
+                Abort(i->sys, str_subscript_err, ind);
+            }
+            ObjRelease(i->heap, GetStringVectorBase(obj)[ind]);
+            GetStringVectorBase(obj)[ind] = htmp;
+            DropH(i, 1);
+            NEXT;
+        OPCODE(OP_CALL):
+            SaveState(i);
+            StartCode(i);
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_CALLI):
+            GetOffset(tmpb);
+            SaveState(i);
+            (*i->heap->intrinsics[(int)tmpb])(i);
+            RestoreState(i);
+            NEXT;
+        OPCODE(OP_TCALL):
+            CheckNativeCaller();
+            SaveState(i);
+            TailCall(i);
+#ifdef JIT
+            /* native code runs the whole function and pops its frame */
+            if (GetHotCode(i, i->code))
+                (*GetNativeCode(i, i->code))(i);
+            else
+                ind = VMFALSE;
+#endif
+            RestoreState(i);
+            ReturnToNative();
+            NEXT;
+        OPCODE(OP_RETURN):
+            CheckNativeCaller();
+            tmp = TOS;
+            SaveState(i);
+            PopFrame(i);
+            RestoreState(i);
+            PushTOS(tmp);
+            ReturnToNative();
+            NEXT;
+        OPCODE(OP_RETURNH):
+            CheckNativeCaller();
+            htmp = *i->hsp;
+            SaveState(i);
+            PopFrame(i);
+            RestoreState(i);
+            PushH(i, htmp);
+            ReturnToNative();
+            NEXT;
+        OPCODE(OP_RETURNV):
+            CheckNativeCaller();
+            SaveState(i);
+            PopFrame(i);
+            RestoreState(i);
+            ReturnToNative();
+            NEXT;
+        OPCODE(OP_DROP):
+            DropTOS();
+            NEXT;
+        OPCODE(OP_DROPH):
+            ObjRelease(i->heap, *i->hsp);
+            DropH(i, 1);
+            NEXT;
+        OPCODE(OP_ADDI):
+            GetValue(tmp);
+            TOS += tmp;
+            NEXT;
+        OPCODE(OP_LINC):
+            GetOffset(tmpb);
+            GetNextValue(tmp);
+            fp[(int)tmpb] += tmp;
+            NEXT;
+        OPCODE(OP_LREF2):
+            GetOffset(tmpb);
+            PushTOS(fp[(int)tmpb]);
+            GetNextOffset(tmpb);
+            PushTOS(fp[(int)tmpb]);
+            NEXT;
+        OPCODE(OP_BRLT):
+            CompareAndBranch(<);
+            NEXT;
+        OPCODE(OP_BRLE):
+            CompareAndBranch(<=);
+            NEXT;
+        OPCODE(OP_BREQ):
+            CompareAndBranch(==);
+            NEXT;
+        OPCODE(OP_BRNE):
+            CompareAndBranch(!=);
+            NEXT;
+        OPCODE(OP_BRGE):
+            CompareAndBranch(>=);
+            NEXT;
+        OPCODE(OP_BRGT):
+            CompareAndBranch(>);
+            NEXT;
+        OPCODE(OP_LBRLT):
+            LocalCompareAndBranch(<);
+            NEXT;
+        OPCODE(OP_LBRLE):
+            LocalCompareAndBranch(<=);
+            NEXT;
+        OPCODE(OP_LBREQ):
+            LocalCompareAndBranch(==);
+            NEXT;
+        OPCODE(OP_LBRNE):
+            LocalCompareAndBranch(!=);
+            NEXT;
+        OPCODE(OP_LBRGE):
+            LocalCompareAndBranch(>=);
+            NEXT;
+        OPCODE(OP_LBRGT):
+            LocalCompareAndBranch(>);
+            NEXT;
+        OPCODE(OP_FORL):
+            GetOffset(tmpb);
+            vptr = &fp[(int)tmpb];
+            ForLoop();
+            NEXT;
+        OPCODE(OP_NEXTL):
+            GetOffset(tmpb);
+            vptr = &fp[(int)tmpb];
+            NextLoop();
+            NEXT;
+        OPCODE(OP_FORG):
+            GetValue(tmp);
+            vptr = &GetSymbolPtr(ValueToHandle(tmp))->v.iValue;
+            ForLoop();
+            NEXT;
+        OPCODE(OP_NEXTG):
+            GetValue(tmp);
+            vptr = &GetSymbolPtr(ValueToHandle(tmp))->v.iValue;
+            NextLoop();
+            NEXT;
+#ifdef REGISTER_VM
+        OPCODE(R_NOT):
+            RegisterUnary(tmp2 ? VMFALSE : VMTRUE);
+            NEXT;
+        OPCODE(R_NEG):
+            RegisterUnary(-tmp2);
+            NEXT;
+        OPCODE(R_BNOT):
+            RegisterUnary(~tmp2);
+            NEXT;
+        OPCODE(R_ADD):
+            RegisterBinary(tmp + tmp2);
+            NEXT;
+        OPCODE(R_SUB):
+            RegisterBinary(tmp - tmp2);
+            NEXT;
+        OPCODE(R_MUL):
+            RegisterBinary(tmp * tmp2);
+            NEXT;
+        OPCODE(R_DIV):
+            RegisterBinary(tmp2 == 0 ? 0 : tmp / tmp2);
+            NEXT;
+        OPCODE(R_REM):
+            RegisterBinary(tmp2 == 0 ? 0 : tmp % tmp2);
+            NEXT;
+        OPCODE(R_BAND):
+            RegisterBinary(tmp & tmp2);
+            NEXT;
+        OPCODE(R_BOR):
+            RegisterBinary(tmp | tmp2);
+            NEXT;
+        OPCODE(R_BXOR):
+            RegisterBinary(tmp ^ tmp2);
+            NEXT;
+        OPCODE(R_SHL):
+            RegisterBinary(tmp << tmp2);
+            NEXT;
+        OPCODE(R_SHR):
+            RegisterBinary(tmp >> tmp2);
+            NEXT;
+        OPCODE(R_LT):
+            RegisterBinary(tmp < tmp2 ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(R_LE):
+            RegisterBinary(tmp <= tmp2 ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(R_EQ):
+            RegisterBinary(tmp == tmp2 ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(R_NE):
+            RegisterBinary(tmp != tmp2 ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(R_GE):
+            RegisterBinary(tmp >= tmp2 ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(R_GT):
+            RegisterBinary(tmp > tmp2 ? VMTRUE : VMFALSE);
+            NEXT;
+        OPCODE(R_MOV):
+            RegisterUnary(tmp2);
+            NEXT;
+        OPCODE(R_LI):
+            GetValue(tmp);
+            GetNextValue(tmp2);
+            *RegAddr(tmp) = tmp2;
+            NEXT;
+        OPCODE(R_BRT):
+            GetValue(tmp);
+            GetNextValue(tmp2);
+            if (RegValue(tmp))
+                Branch(tmp2);
+            NEXT;
+        OPCODE(R_BRF):
+            GetValue(tmp);
+            GetNextValue(tmp2);
+            if (!RegValue(tmp))
+                Branch(tmp2);
+            NEXT;
+        OPCODE(R_BRLT):
+            RegisterCompareAndBranch(<);
+            NEXT;
+        OPCODE(R_BRLE):
+            RegisterCompareAndBranch(<=);
+            NEXT;
+        OPCODE(R_BREQ):
+            RegisterCompareAndBranch(==);
+            NEXT;
+        OPCODE(R_BRNE):
+            RegisterCompareAndBranch(!=);
+            NEXT;
+        OPCODE(R_BRGE):
+            RegisterCompareAndBranch(>=);
+            NEXT;
+        OPCODE(R_BRGT):
+            RegisterCompareAndBranch(>);
+            NEXT;
+        OPCODE(R_ADJSP):
+            GetValue(tmp);
+            sp -= tmp;
+            NEXT;
+#endif
+        DEFAULT:
+#ifndef UNCHECKED
+            SaveState(i);
+            Abort(i->sys, str_opcode_err, BadOpcode());
+#endif
+            NEXT;
+        }
+    }
+}
+
+/* StartCode - call the function whose handle is on the top of the handle stack
+ *
+ * Code objects are kept alive by the constants and code that refer to them
+ * so calls don't count references to them.
+ */
+static void StartCode(Interpreter *i)
+{
+    VMHANDLE code = PopH(i);
+    VMVALUE *fp;
+    uint8_t *p;
+#ifdef JIT
+    NativeCode *native;
+#endif
+
+    /* the verifier only lets code call known functions */
+#ifndef UNCHECKED
+    if (!code)
+        Abort(i->sys, str_not_code_object_err, code);
+#endif
+        
+    switch (GetHeapObjType(code)) {
+    case ObjTypeCode:
+        p = GetCodePtr(code);
+        CheckStack(i, p, F_SIZE, HF_SIZE);
+        fp = i->sp;
+        fp[F_FP] = (VMVALUE)(i->fp - i->stack);
+        fp[F_HFP] = (VMVALUE)(i->hfp - (VMHANDLE *)i->stack);
+        fp[F_PC] = (VMVALUE)(i->pc - i->cbase);
+        i->hfp = i->hsp;
+        PushH(i, i->code);
+        i->fp = fp;
+        i->sp = fp - F_SIZE;
+        EnterCode(i, code, p);
+#ifdef JIT
+        /* native code runs the whole function and pops its frame */
+        if ((native = GetHotCode(i, code)) != NULL)
+            (*native)(i);
+#endif
+        break;
+    case ObjTypeIntrinsic:
+        (*GetIntrinsicHandler(code))(i);
+        break;
+#ifndef UNCHECKED
+    default:
+        Abort(i->sys, str_not_code_object_err, code);
+        break;
+#endif
+    }
+}
+
+/* TailCall - replace the current function with the one whose handle is on the top of the handle stack
+ *
+ * The arguments of the call are moved down over the arguments of the current
+ * function and the new frame keeps its saved registers so the called function
+ * returns straight to the caller. Only the arguments can be on the stacks.
+ */
+static void TailCall(Interpreter *i)
+{
+    VMHANDLE code = PopH(i);
+    VMVALUE savedFP, savedHFP, savedPC;
+    int argumentCount, handleArgumentCount, count, hcount, n;
+    VMHANDLE caller;
+    VMVALUE *fp;
+    VMHANDLE *hfp;
+    uint8_t *p;
+
+    /* the verifier only lets code tail call known functions */
+#ifndef UNCHECKED
+    if (!code || GetHeapObjType(code) != ObjTypeCode)
+        Abort(i->sys, str_not_code_object_err, code);
+#endif
+
+    /* release the handle arguments of the current function */
+    GetArgumentCounts(i, argumentCount, handleArgumentCount);
+    for (n = 0; n < handleArgumentCount; ++n)
+        ObjRelease(i->heap, i->hfp[-n]);
+
+    /* move the new arguments into place */
+    p = GetCodePtr(code);
+    count = VMCODEBYTE(p + FD_ARGS);
+    hcount = VMCODEBYTE(p + FD_HARGS);
+    savedFP = i->fp[F_FP];
+    savedHFP = i->fp[F_HFP];
+    savedPC = i->fp[F_PC];
+    caller = i->hfp[HF_CODE];
+    fp = i->fp + argumentCount - count;
+    hfp = i->hfp - handleArgumentCount + hcount;
+    memmove(fp, i->sp, count * sizeof(VMVALUE));
+    memmove(hfp - hcount + 1, i->hsp - hcount + 1, hcount * sizeof(VMHANDLE));
+
+    /* rebuild the frame around them */
+    fp[F_FP] = savedFP;
+    fp[F_HFP] = savedHFP;
+    fp[F_PC] = savedPC;
+    hfp[HF_CODE] = caller;
+    i->fp = fp;
+    i->sp = fp - F_SIZE;
+    i->hfp = hfp;
+    i->hsp = hfp + HF_SIZE;
+    CheckStack(i, p, 0, 0);
+    EnterCode(i, code, p);
+}
+
+/* PopFrame - pop the frame of the current function and its arguments */
+static void PopFrame(Interpreter *i)
+{
+    int argumentCount, handleArgumentCount;
+    GetArgumentCounts(i, argumentCount, handleArgumentCount);
+    i->code = i->hfp[HF_CODE];
+    i->hsp = i->hfp;
+    while (--handleArgumentCount >= 0) {
+        ObjRelease(i->heap, *i->hsp);
+        DropH(i, 1);
+    }
+    i->cbase = GetCodeBase(i, i->code);
+    i->pc = i->cbase + i->fp[F_PC];
+    i->hfp = (VMHANDLE *)i->stack + i->fp[F_HFP];
+    i->sp = i->fp + argumentCount;
+    i->fp = i->stack + i->fp[F_FP];
+}
+
+void StringCat(Interpreter *i, int count)
+{
+    VMHANDLE *args = i->hsp - (count - 1);
+    VMHANDLE hStr;
+    uint8_t *str;
+    size_t len, n;
+    int k;
+
+    /* find the length of the result (a NULL handle is an empty string) */
+    for (len = 0, k = 0; k < count; ++k)
+        if (args[k])
+            len += GetStringSize(args[k]);
+
+    /* allocate the result string (this can compact the heap so get the source pointers after) */
+    if (!(hStr = NewString(i->heap, len)))
+        Abort(i->sys, "insufficient memory");
+    str = GetStringPtr(hStr);
+
+    /* copy the source strings into the result string */
+    for (k = 0; k < count; ++k)
+        if (args[k]) {
+            n = GetStringSize(args[k]);
+            memcpy(str, GetStringData(args[k]), n);
+            str += n;
+        }
+
+    /* release the source strings and leave the result in place of the first */
+    for (k = 0; k < count; ++k)
+        ObjRelease(i->heap, args[k]);
+    DropH(i, count - 1);
+    *i->hsp = hStr;
+}
+
+/* StringCompare - compare the two strings on top of the handle stack and push the result on the value stack
+ *
+ * Strings of different lengths can't be equal so = and <> only look at the
+ * bytes when the lengths match.
+ */
+void StringCompare(Interpreter *i, int op)
+{
+    VMHANDLE hStr2 = PopH(i);
+    VMHANDLE hStr1 = PopH(i);
+    size_t len1 = hStr1 ? GetStringSize(hStr1) : 0;
+    size_t len2 = hStr2 ? GetStringSize(hStr2) : 0;
+    VMVALUE result;
+    int cmp;
+
+    /* compare the strings */
+    if ((op == OP_EQ || op == OP_NE) && len1 != len2)
+        cmp = 1;
+    else if ((cmp = (len1 > 0 && len2 > 0 ? memcmp(GetStringData(hStr1), GetStringData(hStr2), len1 < len2 ? len1 : len2) : 0)) == 0)
+        cmp = (len1 > len2) - (len1 < len2);
+
+    /* apply the comparison operator */
+    switch (op) {
+    case OP_LT: result = (cmp < 0);     break;
+    case OP_LE: result = (cmp <= 0);    break;
+    case OP_EQ: result = (cmp == 0);    break;
+    case OP_NE: result = (cmp != 0);    break;
+    case OP_GE: result = (cmp >= 0);    break;
+    case OP_GT: result = (cmp > 0);     break;
+    default:    result = VMFALSE;       break;
+    }
+
+    /* release the two argument strings */
+    ObjRelease(i->heap, hStr1);
+    ObjRelease(i->heap, hStr2);
+    CPush(i, result ? VMTRUE : VMFALSE);
+}
+
+/* StringAppend - append the string on top of the handle stack to the string in a variable
+ *
+ * Returns the new value for the variable. A string only the variable refers
+ * to is extended in place when the space after it in the heap is free.
+ * Otherwise the result is a copy with as much free space again after it so
+ * building a string a piece at a time doesn't copy all of it each time.
+ */
+VMHANDLE StringAppend(Interpreter *i, VMHANDLE hStr)
+{
+    VMHANDLE hTail = *i->hsp;
+    size_t len = hStr ? GetStringSize(hStr) : 0;
+    size_t tailLen = hTail ? GetStringSize(hTail) : 0;
+    VMHANDLE hNew;
+
+    /* extend the string in place if nothing else refers to it */
+    if (hStr && !IsStringSlice(hStr) && !IsImmortal(hStr) && GetHeapObjHdr(hStr)->refCnt == 1 && ObjExtend(i->heap, hStr, len + tailLen))
+        hNew = hStr;
+
+    /* otherwise, copy it to a new string with room to grow */
+    else {
+        if (!(hNew = ObjAllocExtra(i->heap, ObjTypeString, len + tailLen, len + tailLen)))
+            Abort(i->sys, "insufficient memory");
+        if (len > 0)
+            memcpy(GetStringPtr(hNew), GetStringData(hStr), len);
+        ObjRelease(i->heap, hStr);
+    }
+
+    /* copy the appended string and release it */
+    if (tailLen > 0)
+        memcpy(GetStringPtr(hNew) + len, GetStringData(hTail), tailLen);
+    ObjRelease(i->heap, hTail);
+    DropH(i, 1);
+    return hNew;
+}
+
+void ShowStack(Interpreter *i)
+{
+    VMHANDLE *hp;
+    VMVALUE *p;
+    
+    for (hp = (VMHANDLE *)i->stack; hp <= i->hsp; ++hp) {
+        if (hp == i->hfp)
+            VM_printf(str_hfp_tag);
+        VM_printf(str_hstack_entry_fmt, HandleToValue(*hp));
+    }
+    
+    VM_printf(str_stack_separator);
+    
+    for (p = i->sp; p < i->stackTop; ++p) {
+        if (p == i->fp)
+            VM_printf(str_fp_tag);
+        VM_printf(str_stack_entry, *p);
+    }
+    
+    VM_putchar('\n');
+}
+
+void StackOverflow(Interpreter *i)
+{
+    Abort(i->sys, str_stack_overflow_err);
+}
+
+/* CheckStack - make sure there is room for everything a code object can push
+ *
+ * The frame descriptor at the start of the code has the number of locals
+ * and the most values and handles the code ever pushes. The TOS_SPARE word
+ * and the word SaveState spills are counted as well as the frame itself.
+ */
+static void CheckStack(Interpreter *i, uint8_t *p, int frame, int hframe)
+{
+    int count = frame + VMCODEBYTE(p + FD_LOCALS) + VMCODEBYTE(p + FD_DEPTH) + TOS_SPARE + 1;
+    int hcount = hframe + VMCODEBYTE(p + FD_HLOCALS) + VMCODEBYTE(p + FD_HDEPTH);
+    if (i->sp - count - STACK_SLACK <= (VMVALUE *)(i->hsp + hcount))
+        StackOverflow(i);
+}
+
+#ifdef JIT
+
+/* CallFromNative - call a function from native code */
+void CallFromNative(Interpreter *i)
+{
+    VMVALUE *fp = i->fp;
+    StartCode(i);
+    
+    /* run an interpreted function until it returns */
+    if (i->fp != fp) {
+        i->fp[F_PC] = NATIVE_PC;
+        ExecuteLoop(i);
+    }
+}
+
+/* TailCallFromNative - make a tail call from native code
+ *
+ * This returns the native code for the called function for the caller to
+ * jump to so that tail calls between native functions don't use up the
+ * native stack. An interpreted function is run until it returns.
+ */
+NativeCode *TailCallFromNative(Interpreter *i)
+{
+    NativeCode *native;
+    VMVALUE pc;
+    TailCall(i);
+    if ((native = GetHotCode(i, i->code)) == NULL) {
+        pc = i->fp[F_PC];
+        i->fp[F_PC] = NATIVE_PC;
+        ExecuteLoop(i);
+        i->pc = i->cbase + pc;
+    }
+    return native;
+}
+
+/* ReturnFromNative - return from a native function */
+void ReturnFromNative(Interpreter *i)
+{
+    PopFrame(i);
+}
+
+/* EnterNativeLoop - compile a function with a hot loop and carry on in native code
+ *
+ * This is called with the interpreter state saved and pc at the target of the
+ * backward branch. The native code runs until the function halts or returns.
+ */
+static int EnterNativeLoop(Interpreter *i)
+{
+    VMVALUE *fp = i->fp;
+    int nativeCaller = (fp[F_PC] == NATIVE_PC);
+    uint8_t *entry;
+    
+    if (!CompileHotCode(i, i->code, TIER_LOOPS)
+    ||  !(entry = NativeLoopEntry(i, i->code, BytecodeOffset(i))))
+        return VMFALSE;
+    EnterNative(i, entry);
+    
+    /* the frame is still there if the main code halted */
+    return i->fp == fp || nativeCaller;
+}
+
+/* BytecodeOffset - get the bytecode offset of the interpreter pc */
+static VMVALUE BytecodeOffset(Interpreter *i)
+{
+#ifdef PREDECODE
+#ifdef REGISTER_VM
+    /* register code doesn't line up with the bytecode */
+    return -1;
+#else
+    uint8_t *base = GetCodePtr(i->code), *p;
+    VMVALUE target = i->pc - i->cbase, n;
+    for (p = base, n = 0; n < target; p += InstructionSize(VMCODEBYTE(p)))
+        n += DecodedSize(VMCODEBYTE(p));
+    return n == target ? p - base : -1;
+#endif
+#else
+    return i->pc - i->cbase;
+#endif
+}
+
+#endif
+
+/* AfterCompact - called after the heap manager compacts the heap */
+static void AfterCompact(void *cookie)
+{
+#ifndef PREDECODE
+    /* pre-decoded code lives outside the heap and never moves */
+    Interpreter *i = (Interpreter *)cookie;
+    uint8_t *cbase = GetCodePtr(i->code);
+    i->pc = cbase + (i->pc - i->cbase);
+    i->cbase = cbase;
+#endif
+}
+
+#ifdef PREDECODE
+
+/* DecodeAllCode - translate every code object in the heap */
+static int DecodeAllCode(Interpreter *i)
+{
+    ObjHeap *heap = i->heap;
+    VMHANDLE h;
+    
+    /* allocate the table mapping code handles to pre-decoded code */
+    if (!(i->decoded = (Instr **)AllocateFreeSpace(i->sys, heap->nHandles * sizeof(Instr *))))
+        return VMFALSE;
+    memset(i->decoded, 0, heap->nHandles * sizeof(Instr *));
+    
+    /* the pre-decoded code is allocated contiguously after the table */
+    i->decodedBase = i->decodedTop = (Instr *)i->sys->freeNext;
+    
+    /* free handles point into the handle table or are NULL */
+    for (h = heap->handles; h < heap->endHandles; ++h) {
+        if ((uint8_t *)*h >= heap->data && (uint8_t *)*h < heap->free
+        &&  GetHeapObjHdr(h)->handle == h
+        &&  GetHeapObjType(h) == ObjTypeCode) {
+#ifdef REGISTER_VM
+            if (!(i->decoded[h - heap->handles] = TranslateCode(i, h)))
+                return VMFALSE;
+#else
+            if (!(i->decoded[h - heap->handles] = DecodeCode(i, h)))
+                return VMFALSE;
+#endif
+        }
+    }
+    
+    return VMTRUE;
+}
+
+/* additional operands go in the following entries which are never dispatched */
+#define AddOperand(ip, v)   do {                                \
+                                ++(ip);                         \
+                                (ip)->op.opcode = OP_HALT;      \
+                                (ip)->operand = (v);            \
+                            } while (0)
+
+#ifndef REGISTER_VM
+
+/* DecodeCode - translate a single code object */
+static Instr *DecodeCode(Interpreter *i, VMHANDLE code)
+{
+    uint8_t *base = GetCodePtr(code);
+    uint8_t *end = base + GetHeapObjSize(code);
+    VMVALUE *index;
+    Instr *decoded, *ip;
+    uint8_t *p;
+    int n;
+    
+    /* count the pre-decoded instructions */
+    for (p = base, n = 0; p < end; p += InstructionSize(VMCODEBYTE(p)))
+        n += DecodedSize(VMCODEBYTE(p));
+        
+    /* allocate space for the pre-decoded instructions */
+    if (!(decoded = (Instr *)AllocateFreeSpace(i->sys, n * sizeof(Instr))))
+        return NULL;
+    i->decodedTop = decoded + n;
+    
+    /* use the free space above that to map byte offsets to instruction indexes */
+    index = (VMVALUE *)i->sys->freeNext;
+    if ((uint8_t *)(index + (end - base) + 1) > i->sys->freeTop)
+        return NULL;
+    for (p = base, n = 0; p < end; p += InstructionSize(VMCODEBYTE(p))) {
+        index[p - base] = n;
+        n += DecodedSize(VMCODEBYTE(p));
+    }
+    index[end - base] = n;
+    
+    /* translate the instructions */
+    for (p = base, ip = decoded; p < end; p += InstructionSize(VMCODEBYTE(p)))
+        ip = DecodeInstr(ip, base, p, index);
+    
+    return decoded;
+}
+
+#endif
+
+/* branch targets are instruction indexes or bytecode offsets if there is no index */
+#define BranchTarget(offset)    (index ? index[offset] : (offset))
+
+/* DecodeInstr - translate a single instruction and return the next free entry */
+Instr *DecodeInstr(Instr *ip, uint8_t *base, uint8_t *p, VMVALUE *index)
+{
+    VMVALUE tmp;
+    
+    ip->op.opcode = VMCODEBYTE(p++);
+    switch (ip->op.opcode) {
+    case OP_BRT:
+    case OP_BRTSC:
+    case OP_BRF:
+    case OP_BRFSC:
+    case OP_BR:
+    case OP_BRLT:
+    case OP_BRLE:
+    case OP_BREQ:
+    case OP_BRNE:
+    case OP_BRGE:
+    case OP_BRGT:
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        ip->operand = BranchTarget(p - base + tmp);
+        break;
+    case OP_LIT:
+    case OP_GREF:
+    case OP_GSET:
+    case OP_LITH:
+    case OP_GREFH:
+    case OP_GSETH:
+    case OP_GAPPH:
+    case OP_ADDI:
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        ip->operand = tmp;
+        break;
+    case OP_LINC:
+        ip->operand = (int8_t)VMCODEBYTE(p++);
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        AddOperand(ip, tmp);
+        break;
+    case OP_LREF2:
+        ip->operand = (int8_t)VMCODEBYTE(p++);
+        AddOperand(ip, (int8_t)VMCODEBYTE(p++));
+        break;
+    case OP_LBRLT:
+    case OP_LBRLE:
+    case OP_LBREQ:
+    case OP_LBRNE:
+    case OP_LBRGE:
+    case OP_LBRGT:
+        ip->operand = (int8_t)VMCODEBYTE(p++);
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        AddOperand(ip, tmp);
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        AddOperand(ip, BranchTarget(p - base + tmp));
+        break;
+    case OP_FORL:
+    case OP_NEXTL:
+        ip->operand = (int8_t)VMCODEBYTE(p++);
+        AddOperand(ip, (int8_t)VMCODEBYTE(p++));
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        AddOperand(ip, BranchTarget(p - base + tmp));
+        break;
+    case OP_FORG:
+    case OP_NEXTG:
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        ip->operand = tmp;
+        AddOperand(ip, (int8_t)VMCODEBYTE(p++));
+        get_VMVALUE(tmp, VMCODEBYTE(p++));
+        AddOperand(ip, BranchTarget(p - base + tmp));
+        break;
+    case OP_LREF:
+    case OP_LSET:
+    case OP_LTEE:
+    case OP_LREFH:
+    case OP_LSETH:
+    case OP_LAPPH:
+    case OP_CALLI:
+    case OP_CATN:
+    case OP_SCMP:
+        ip->operand = (int8_t)VMCODEBYTE(p++);
+        break;
+    case OP_RESERVE:
+        /* PopFrame gets the argument counts from here */
+        ip->operand = VMCODEBYTE(p + FD_ARGS - 1);
+        ip->operand |= VMCODEBYTE(p + FD_HARGS - 1) << 8;
+        break;
+    default:
+        /* keep the opcode for the undefined opcode error message */
+        ip->operand = ip->op.opcode;
+        break;
+    }
+    
+    return ip + 1;
+}
+
+#ifndef REGISTER_VM
+
+/* DecodedSize - get the number of pre-decoded entries for an instruction */
+static int DecodedSize(int opcode)
+{
+    switch (opcode) {
+    case OP_LINC:
+    case OP_LREF2:
+        return 2;
+    case OP_LBRLT:
+    case OP_LBRLE:
+    case OP_LBREQ:
+    case OP_LBRNE:
+    case OP_LBRGE:
+    case OP_LBRGT:
+    case OP_FORL:
+    case OP_NEXTL:
+    case OP_FORG:
+    case OP_NEXTG:
+        return 3;
+    default:
+        return 1;
+    }
+}
+
+#endif
+
+#endif
+
+/* InstructionSize - get the size of a bytecode instruction */
+int InstructionSize(int opcode)
+{
+    switch (opcode) {
+    case OP_BRT:
+    case OP_BRTSC:
+    case OP_BRF:
+    case OP_BRFSC:
+    case OP_BR:
+    case OP_LIT:
+    case OP_GREF:
+    case OP_GSET:
+    case OP_LITH:
+    case OP_GREFH:
+    case OP_GSETH:
+    case OP_GAPPH:
+    case OP_ADDI:
+    case OP_BRLT:
+    case OP_BRLE:
+    case OP_BREQ:
+    case OP_BRNE:
+    case OP_BRGE:
+    case OP_BRGT:
+        return 1 + sizeof(VMVALUE);
+    case OP_LREF:
+    case OP_LSET:
+    case OP_LTEE:
+    case OP_LREFH:
+    case OP_LSETH:
+    case OP_LAPPH:
+    case OP_CALLI:
+    case OP_CATN:
+    case OP_SCMP:
+        return 2;
+    case OP_LREF2:
+        return 3;
+    case OP_RESERVE:
+        return FD_SIZE;
+    case OP_LINC:
+        return 2 + sizeof(VMVALUE);
+    case OP_LBRLT:
+    case OP_LBRLE:
+    case OP_LBREQ:
+    case OP_LBRNE:
+    case OP_LBRGE:
+    case OP_LBRGT:
+    case OP_FORG:
+    case OP_NEXTG:
+        return 2 + 2 * sizeof(VMVALUE);
+    case OP_FORL:
+    case OP_NEXTL:
+        return 3 + sizeof(VMVALUE);
+    default:
+        return 1;
+    }
+}
+
+FLASH_SPACE char str_subscript_err[]        = "subscript out of bounds: %d";
+FLASH_SPACE char str_stack_overflow_err[]   = "stack overflow";
+FLASH_SPACE char str_not_code_object_err[]  = "not code object: %d";
+FLASH_SPACE char str_opcode_err[]           = "undefined opcode 0x%02x";
+FLASH_SPACE char str_value_fmt[]            = "%d";
+FLASH_SPACE char str_hfp_tag[]              = " <hfp>";
+FLASH_SPACE char str_hstack_entry_fmt[]     = " %08x";
+FLASH_SPACE char str_stack_separator[]      = " ---";
+FLASH_SPACE char str_fp_tag[]               = " <fp>";
+FLASH_SPACE char str_stack_entry[]          = " %d";
@@ -0,0 +1,930 @@
+/* db_vmjit.c - native code generator for x86-64 hosts
+ *
+ * Copyright (c) 2012 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+/* With JIT defined code objects that turn out to be hot are compiled into
+ * x86-64 machine code. The interpreter counts the calls of each function and
+ * the backward branches it takes and calls CompileHotCode when either count
+ * reaches its threshold. A hot loop then carries on in native code from the
+ * target of the branch. Each bytecode instruction is replaced by a fixed
+ * template that works on the same stack and frame as the interpreter so
+ * native and interpreted functions can call each other freely. Code objects
+ * that use an opcode without a template are left to the interpreter.
+ *
+ * While native code runs rbx holds the interpreter state, r12 the frame
+ * pointer and r13 the stack pointer. The stack space a call needs is checked
+ * once when its frame is built so the templates push without any checks.
+ * Globals are reached through their handles which don't move when the heap
+ * is compacted so the native code never needs to be patched.
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include "db_vm.h"
+
+#ifdef JIT
+
+#ifndef __x86_64__
+#error JIT requires an x86-64 host
+#endif
+
+/* size of the executable code region */
+#ifndef JIT_CODE_SIZE
+#define JIT_CODE_SIZE   (256 * 1024)
+#endif
+
+/* default tier thresholds (a call threshold of zero compiles everything up front) */
+#ifndef JIT_CALL_THRESHOLD
+#define JIT_CALL_THRESHOLD  10
+#endif
+#ifndef JIT_LOOP_THRESHOLD
+#define JIT_LOOP_THRESHOLD  1000
+#endif
+
+/* largest template for a single bytecode instruction */
+#define MAXTEMPLATE     96
+
+/* registers */
+#define RAX             0
+#define RCX             1
+#define RDX             2
+#define RBX             3
+#define RSP             4
+#define RBP             5
+#define RSI             6
+#define RDI             7
+#define R12             12
+#define R13             13
+#define R14             14
+#define R15             15
+
+/* register assignments */
+#define RI              RBX         /* interpreter state */
+#define RFP             R12         /* frame pointer */
+#define RSTK            R13         /* stack pointer */
+#define RSAVE           R15         /* return value across calls */
+
+/* condition codes */
+#define CC_B            0x2
+#define CC_AE           0x3
+#define CC_E            0x4
+#define CC_NE           0x5
+#define CC_BE           0x6
+#define CC_S            0x8
+#define CC_L            0xc
+#define CC_GE           0xd
+#define CC_LE           0xe
+#define CC_G            0xf
+
+/* special branch targets */
+#define T_EXIT          -2          /* function epilogue */
+#define T_TAIL          -3          /* function epilogue that jumps to the native code in RAX */
+
+/* native code generator state */
+typedef struct {
+    uint8_t *base;                  /* bytecode being compiled */
+    uint8_t *code;                  /* native code */
+    uint8_t *p;                     /* next native code byte */
+    VMVALUE *index;                 /* bytecode offset to native code offset */
+    VMVALUE *fixups;                /* rel32 offset and target pairs */
+    int fixupCount;
+    ObjHeap *heap;                  /* heap with the intrinsic function table */
+} JitState;
+
+/* executable code region */
+static uint8_t *jitBase = NULL;
+static uint8_t *jitNext;
+
+/* tier thresholds and transition counts */
+static TierStats tierStats = { JIT_CALL_THRESHOLD, JIT_LOOP_THRESHOLD };
+
+/* compare opcodes map to these condition codes */
+static uint8_t compareCC[] = { CC_L, CC_LE, CC_E, CC_NE, CC_GE, CC_G };
+
+/* prototypes for local functions */
+static NativeCode *CompileCode(Interpreter *i, VMHANDLE code, CodeTier *tier);
+static int SetWritable(int writable);
+static void Prologue(JitState *j);
+static int Compilable(uint8_t *base, uint8_t *end);
+static void CompileInstr(JitState *j, uint8_t *p, int fuseCall);
+static void ForTemplate(JitState *j, int var, VMVALUE disp, int slot, VMVALUE target);
+static void NextTemplate(JitState *j, int var, VMVALUE disp, int slot, VMVALUE target);
+static void DivTemplate(JitState *j, int result);
+static void CallHelper(JitState *j, void *fcn);
+static void PushReg(JitState *j, int reg);
+static void PushHandle(JitState *j, int addRef);
+static void PopReg(JitState *j, int reg);
+static void AddSP(JitState *j, int reg, VMVALUE n);
+static void LoadGlobal(JitState *j, int reg, VMVALUE symbol);
+static void Jcc(JitState *j, int cc, VMVALUE target);
+static void Jmp(JitState *j, VMVALUE target);
+static uint8_t *JccShort(JitState *j, int cc);
+static void PatchShort(JitState *j, uint8_t *patch);
+static void Mem(JitState *j, int w, int op, int reg, int base, VMVALUE disp);
+static void Reg(JitState *j, int w, int op, int reg, int rm);
+static void MovImm(JitState *j, int reg, VMVALUE value);
+static void PushNative(JitState *j, int reg);
+static void PopNative(JitState *j, int reg);
+static void Long(JitState *j, VMVALUE value);
+static VMVALUE GetWord(uint8_t *p);
+static VMVALUE BranchTarget(uint8_t *base, uint8_t *p);
+static void DropHandleHelper(Interpreter *i);
+static void StoreHandleHelper(Interpreter *i, int offset);
+
+/* emit a byte */
+#define Byte(j, b)      (*(j)->p++ = (uint8_t)(b))
+
+/* get a handle operand */
+#define GetHandle(p)    ValueToHandle(GetWord(p))
+
+/* InitTiers - setup the tier state of every code object in the heap */
+int InitTiers(Interpreter *i)
+{
+    ObjHeap *heap = i->heap;
+    JitState state, *j = &state;
+    VMHANDLE h;
+
+    /* allocate the table of tier states indexed by code handle */
+    if (!(i->tiers = (CodeTier *)AllocateFreeSpace(i->sys, heap->nHandles * sizeof(CodeTier))))
+        return VMFALSE;
+    memset(i->tiers, 0, heap->nHandles * sizeof(CodeTier));
+
+    /* without native code everything stays interpreted */
+    i->callThreshold = i->loopThreshold = 0;
+
+    /* allocate the executable code region the first time through */
+    if (!jitBase) {
+        jitBase = (uint8_t *)mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (jitBase == (uint8_t *)MAP_FAILED) {
+            jitBase = NULL;
+            return VMTRUE;
+        }
+    }
+    else if (!SetWritable(VMTRUE))
+        return VMTRUE;
+
+    /* EnterNative loads the registers like a function prologue and jumps to its second argument */
+    j->code = j->p = jitBase;
+    Prologue(j);
+    Byte(j, 0xff); Byte(j, 0xe6);
+    jitNext = j->p;
+
+    /* compile everything now if there is no call threshold */
+    if (tierStats.callThreshold == 0) {
+        for (h = heap->handles; h < heap->endHandles; ++h) {
+            if ((uint8_t *)*h >= heap->data && (uint8_t *)*h < heap->free
+            &&  GetHeapObjHdr(h)->handle == h
+            &&  GetHeapObjType(h) == ObjTypeCode
+            &&  CompileCode(i, h, &i->tiers[h - heap->handles]))
+                ++tierStats.promotedByCalls;
+        }
+    }
+
+    /* make the native code executable */
+    if (!SetWritable(VMFALSE)) {
+        memset(i->tiers, 0, heap->nHandles * sizeof(CodeTier));
+        return VMTRUE;
+    }
+
+    i->callThreshold = tierStats.callThreshold;
+    i->loopThreshold = tierStats.loopThreshold;
+    return VMTRUE;
+}
+
+/* CompileHotCode - compile a function that has reached a tier threshold */
+NativeCode *CompileHotCode(Interpreter *i, VMHANDLE code, int reason)
+{
+    CodeTier *tier = &i->tiers[code - i->heap->handles];
+    NativeCode *native;
+
+    /* another threshold may have been reached first */
+    if (tier->native)
+        return tier->native;
+
+    /* compile the function */
+    if (!SetWritable(VMTRUE))
+        return NULL;
+    native = CompileCode(i, code, tier);
+    if (!SetWritable(VMFALSE)) {
+        tier->native = native = NULL;
+        i->callThreshold = i->loopThreshold = 0;
+    }
+
+    /* don't try again if the function can't be compiled */
+    if (!native) {
+        tier->calls = i->callThreshold;
+        tier->backEdges = i->loopThreshold;
+        ++tierStats.rejected;
+    }
+    else if (reason == TIER_LOOPS)
+        ++tierStats.promotedByLoops;
+    else
+        ++tierStats.promotedByCalls;
+
+    return native;
+}
+
+/* NativeLoopEntry - get the native code address of a bytecode offset in a compiled function */
+uint8_t *NativeLoopEntry(Interpreter *i, VMHANDLE code, VMVALUE offset)
+{
+    CodeTier *tier = &i->tiers[code - i->heap->handles];
+    if (!tier->native || offset < 0 || tier->index[offset] < 0)
+        return NULL;
+    ++tierStats.loopEntries;
+    return (uint8_t *)tier->native + tier->index[offset];
+}
+
+/* EnterNative - run native code from an address in the middle of a function */
+void EnterNative(Interpreter *i, uint8_t *entry)
+{
+    (*(void (*)(Interpreter *, uint8_t *))jitBase)(i, entry);
+}
+
+/* SetTierThresholds - set the thresholds used from the next program run on */
+void SetTierThresholds(VMVALUE calls, VMVALUE loops)
+{
+    tierStats.callThreshold = calls;
+    tierStats.loopThreshold = loops;
+}
+
+/* ShowTierStats - show the thresholds and tier transition counts */
+void ShowTierStats(void)
+{
+    VM_printf("call threshold %d, loop threshold %d\n", tierStats.callThreshold, tierStats.loopThreshold);
+    VM_printf("compiled %d for calls, %d for loops, %d rejected\n", tierStats.promotedByCalls, tierStats.promotedByLoops, tierStats.rejected);
+    VM_printf("loops entered in native code %d\n", tierStats.loopEntries);
+}
+
+/* SetWritable - switch the code region between writable and executable */
+static int SetWritable(int writable)
+{
+    return mprotect(jitBase, JIT_CODE_SIZE, PROT_READ | (writable ? PROT_WRITE : PROT_EXEC)) == 0;
+}
+
+/* CompileCode - compile a single code object */
+static NativeCode *CompileCode(Interpreter *i, VMHANDLE code, CodeTier *tier)
+{
+    uint8_t *base = GetCodePtr(code);
+    uint8_t *end = base + GetHeapObjSize(code);
+    int len = end - base;
+    JitState state, *j = &state;
+    VMVALUE exit, tail, offset, *fixup;
+    uint8_t *p, *next;
+    int n;
+
+    /* leave code with unsupported opcodes to the interpreter */
+    if (!Compilable(base, end))
+        return NULL;
+
+    /* the offset map goes first followed by the native code */
+    for (p = base, n = 0; p < end; p += InstructionSize(VMCODEBYTE(p)))
+        ++n;
+    j->index = (VMVALUE *)jitNext;
+    j->code = j->p = (uint8_t *)(j->index + len + 1);
+
+    /* the fixup list (two per instruction at most) goes after the largest native code */
+    j->fixups = (VMVALUE *)(j->code + (n + 2) * MAXTEMPLATE);
+    if ((uint8_t *)(j->fixups + 4 * (n + 1)) > jitBase + JIT_CODE_SIZE)
+        return NULL;
+    j->fixupCount = 0;
+    j->base = base;
+    j->heap = i->heap;
+
+    /* save the callee saved registers and load the interpreter registers */
+    Prologue(j);
+
+    /* compile each instruction */
+    for (p = base; p < end; p = next) {
+        next = p + InstructionSize(VMCODEBYTE(p));
+        j->index[p - base] = j->p - j->code;
+
+        /* call an intrinsic function directly */
+        if (VMCODEBYTE(p) == OP_LITH && next < end && VMCODEBYTE(next) == OP_CALL) {
+            VMHANDLE object = GetHandle(p + 1);
+            if (object && GetHeapObjType(object) == ObjTypeIntrinsic) {
+                j->index[next - base] = -1;
+                CompileInstr(j, p, VMTRUE);
+                next += InstructionSize(OP_CALL);
+                continue;
+            }
+        }
+
+        CompileInstr(j, p, VMFALSE);
+    }
+    j->index[len] = j->p - j->code;
+
+    /* the epilogue */
+    exit = j->p - j->code;
+    PopNative(j, R15);
+    PopNative(j, R14);
+    PopNative(j, R13);
+    PopNative(j, R12);
+    PopNative(j, RBX);
+    Byte(j, 0xc3);
+
+    /* the epilogue for a tail call to a native function enters it in place of this one */
+    tail = j->p - j->code;
+    Reg(j, 1, 0x89, RI, RDI);
+    PopNative(j, R15);
+    PopNative(j, R14);
+    PopNative(j, R13);
+    PopNative(j, R12);
+    PopNative(j, RBX);
+    Byte(j, 0xff); Byte(j, 0xe0);
+
+    /* patch the branches */
+    for (fixup = j->fixups; fixup < j->fixups + 2 * j->fixupCount; fixup += 2) {
+        switch (fixup[1]) {
+        case T_EXIT:
+            offset = exit;
+            break;
+        case T_TAIL:
+            offset = tail;
+            break;
+        default:
+            /* a branch to a fused intrinsic call can't happen so give up */
+            if ((offset = j->index[fixup[1]]) < 0)
+                return NULL;
+            break;
+        }
+        offset -= fixup[0] + sizeof(VMVALUE);
+        memcpy(j->code + fixup[0], &offset, sizeof(VMVALUE));
+    }
+
+    /* keep the next function aligned for the offset map */
+    jitNext = j->code + ((j->p - j->code + sizeof(VMVALUE) - 1) & ~(sizeof(VMVALUE) - 1));
+    tier->index = j->index;
+    return tier->native = (NativeCode *)j->code;
+}
+
+/* Prologue - save the callee saved registers and load the interpreter registers */
+static void Prologue(JitState *j)
+{
+    PushNative(j, RBX);
+    PushNative(j, R12);
+    PushNative(j, R13);
+    PushNative(j, R14);     /* keeps the native stack aligned */
+    PushNative(j, R15);
+    Reg(j, 1, 0x89, RDI, RI);
+    Mem(j, 1, 0x8b, RFP, RI, offsetof(Interpreter, fp));
+    Mem(j, 1, 0x8b, RSTK, RI, offsetof(Interpreter, sp));
+}
+
+/* Compilable - check that every instruction in a code object has a template */
+static int Compilable(uint8_t *base, uint8_t *end)
+{
+    uint8_t *p;
+    for (p = base; p < end; p += InstructionSize(VMCODEBYTE(p))) {
+        switch (VMCODEBYTE(p)) {
+        case OP_HALT:
+        case OP_BRT:
+        case OP_BRTSC:
+        case OP_BRF:
+        case OP_BRFSC:
+        case OP_BR:
+        case OP_NOT:
+        case OP_NEG:
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_REM:
+        case OP_BNOT:
+        case OP_BAND:
+        case OP_BOR:
+        case OP_BXOR:
+        case OP_SHL:
+        case OP_SHR:
+        case OP_LT:
+        case OP_LE:
+        case OP_EQ:
+        case OP_NE:
+        case OP_GE:
+        case OP_GT:
+        case OP_LIT:
+        case OP_GREF:
+        case OP_GSET:
+        case OP_LREF:
+        case OP_LSET:
+        case OP_LTEE:
+        case OP_RESERVE:
+        case OP_CALL:
+        case OP_CALLI:
+        case OP_TCALL:
+        case OP_RETURN:
+        case OP_RETURNV:
+        case OP_DROP:
+        case OP_ADDI:
+        case OP_LINC:
+        case OP_LREF2:
+        case OP_BRLT:
+        case OP_BRLE:
+        case OP_BREQ:
+        case OP_BRNE:
+        case OP_BRGE:
+        case OP_BRGT:
+        case OP_LBRLT:
+        case OP_LBRLE:
+        case OP_LBREQ:
+        case OP_LBRNE:
+        case OP_LBRGE:
+        case OP_LBRGT:
+        case OP_FORL:
+        case OP_NEXTL:
+        case OP_FORG:
+        case OP_NEXTG:
+        case OP_LITH:
+        case OP_GREFH:
+        case OP_LREFH:
+        case OP_LSETH:
+        case OP_DROPH:
+        case OP_CAT:
+        case OP_CATN:
+        case OP_SCMP:
+            break;
+        default:
+            return VMFALSE;
+        }
+    }
+    return VMTRUE;
+}
+
+/* CompileInstr - compile a single bytecode instruction */
+static void CompileInstr(JitState *j, uint8_t *p, int fuseCall)
+{
+    int op = VMCODEBYTE(p);
+    VMVALUE disp;
+
+    switch (op) {
+    case OP_HALT:
+        Mem(j, 1, 0x89, RSTK, RI, offsetof(Interpreter, sp));
+        Jmp(j, T_EXIT);
+        break;
+    case OP_BRT:
+    case OP_BRF:
+        PopReg(j, RAX);
+        Reg(j, 0, 0x85, RAX, RAX);
+        Jcc(j, op == OP_BRT ? CC_NE : CC_E, BranchTarget(j->base, p));
+        break;
+    case OP_BRTSC:
+    case OP_BRFSC:
+        Mem(j, 0, 0x83, 7, RSTK, 0);
+        Byte(j, 0);
+        Jcc(j, op == OP_BRTSC ? CC_NE : CC_E, BranchTarget(j->base, p));
+        AddSP(j, RSTK, sizeof(VMVALUE));
+        break;
+    case OP_BR:
+        Jmp(j, BranchTarget(j->base, p));
+        break;
+    case OP_NOT:
+        Mem(j, 0, 0x83, 7, RSTK, 0);
+        Byte(j, 0);
+        Byte(j, 0x0f); Byte(j, 0x90 + CC_E); Byte(j, 0xc0);
+        Byte(j, 0x0f); Byte(j, 0xb6); Byte(j, 0xc0);
+        Mem(j, 0, 0x89, RAX, RSTK, 0);
+        break;
+    case OP_NEG:
+        Mem(j, 0, 0xf7, 3, RSTK, 0);
+        break;
+    case OP_BNOT:
+        Mem(j, 0, 0xf7, 2, RSTK, 0);
+        break;
+    case OP_ADD:
+    case OP_SUB:
+    case OP_BAND:
+    case OP_BOR:
+    case OP_BXOR:
+        PopReg(j, RAX);
+        Mem(j, 0, op == OP_ADD ? 0x01 : op == OP_SUB ? 0x29 : op == OP_BAND ? 0x21 : op == OP_BOR ? 0x09 : 0x31, RAX, RSTK, 0);
+        break;
+    case OP_MUL:
+        PopReg(j, RAX);
+        Mem(j, 0, 0x0faf, RAX, RSTK, 0);
+        Mem(j, 0, 0x89, RAX, RSTK, 0);
+        break;
+    case OP_DIV:
+        DivTemplate(j, RAX);
+        break;
+    case OP_REM:
+        DivTemplate(j, RDX);
+        break;
+    case OP_SHL:
+    case OP_SHR:
+        PopReg(j, RCX);
+        Mem(j, 0, 0xd3, op == OP_SHL ? 4 : 7, RSTK, 0);
+        break;
+    case OP_LT:
+    case OP_LE:
+    case OP_EQ:
+    case OP_NE:
+    case OP_GE:
+    case OP_GT:
+        PopReg(j, RAX);
+        Mem(j, 0, 0x39, RAX, RSTK, 0);
+        Byte(j, 0x0f); Byte(j, 0x90 + compareCC[op - OP_LT]); Byte(j, 0xc0);
+        Byte(j, 0x0f); Byte(j, 0xb6); Byte(j, 0xc0);
+        Mem(j, 0, 0x89, RAX, RSTK, 0);
+        break;
+    case OP_LIT:
+        MovImm(j, RAX, GetWord(p + 1));
+        PushReg(j, RAX);
+        break;
+    case OP_GREF:
+        LoadGlobal(j, RAX, GetWord(p + 1));
+        Mem(j, 0, 0x8b, RAX, RAX, offsetof(Symbol, v));
+        PushReg(j, RAX);
+        break;
+    case OP_GSET:
+        LoadGlobal(j, RCX, GetWord(p + 1));
+        PopReg(j, RAX);
+        Mem(j, 0, 0x89, RAX, RCX, offsetof(Symbol, v));
+        break;
+    case OP_LREF:
+        Mem(j, 0, 0x8b, RAX, RFP, (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE));
+        PushReg(j, RAX);
+        break;
+    case OP_LSET:
+        PopReg(j, RAX);
+        Mem(j, 0, 0x89, RAX, RFP, (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE));
+        break;
+    case OP_LTEE:
+        Mem(j, 0, 0x8b, RAX, RSTK, 0);
+        Mem(j, 0, 0x89, RAX, RFP, (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE));
+        break;
+    case OP_LREF2:
+        Mem(j, 0, 0x8b, RAX, RFP, (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE));
+        PushReg(j, RAX);
+        Mem(j, 0, 0x8b, RAX, RFP, (int8_t)VMCODEBYTE(p + 2) * sizeof(VMVALUE));
+        PushReg(j, RAX);
+        break;
+    case OP_ADDI:
+        Mem(j, 0, 0x81, 0, RSTK, 0);
+        Long(j, GetWord(p + 1));
+        break;
+    case OP_LINC:
+        Mem(j, 0, 0x81, 0, RFP, (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE));
+        Long(j, GetWord(p + 2));
+        break;
+    case OP_DROP:
+        AddSP(j, RSTK, sizeof(VMVALUE));
+        break;
+    case OP_BRLT:
+    case OP_BRLE:
+    case OP_BREQ:
+    case OP_BRNE:
+    case OP_BRGE:
+    case OP_BRGT:
+        PopReg(j, RAX);
+        PopReg(j, RCX);
+        Reg(j, 0, 0x39, RAX, RCX);
+        Jcc(j, compareCC[op - OP_BRLT], BranchTarget(j->base, p));
+        break;
+    case OP_LBRLT:
+    case OP_LBRLE:
+    case OP_LBREQ:
+    case OP_LBRNE:
+    case OP_LBRGE:
+    case OP_LBRGT:
+        Mem(j, 0, 0x81, 7, RFP, (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE));
+        Long(j, GetWord(p + 2));
+        Jcc(j, compareCC[op - OP_LBRLT], BranchTarget(j->base, p));
+        break;
+    case OP_FORL:
+    case OP_NEXTL:
+        disp = (int8_t)VMCODEBYTE(p + 1) * sizeof(VMVALUE);
+        if (op == OP_FORL)
+            ForTemplate(j, RFP, disp, (int8_t)VMCODEBYTE(p + 2), BranchTarget(j->base, p));
+        else
+            NextTemplate(j, RFP, disp, (int8_t)VMCODEBYTE(p + 2), BranchTarget(j->base, p));
+        break;
+    case OP_FORG:
+    case OP_NEXTG:
+        LoadGlobal(j, RSI, GetWord(p + 1));
+        disp = offsetof(Symbol, v);
+        if (op == OP_FORG)
+            ForTemplate(j, RSI, disp, (int8_t)VMCODEBYTE(p + 5), BranchTarget(j->base, p));
+        else
+            NextTemplate(j, RSI, disp, (int8_t)VMCODEBYTE(p + 5), BranchTarget(j->base, p));
+        break;
+    case OP_RESERVE:
+        /* StartCode has already reserved the locals */
+        break;
+    case OP_CALL:
+        CallHelper(j, (void *)CallFromNative);
+        break;
+    case OP_CALLI:
+        CallHelper(j, (void *)j->heap->intrinsics[VMCODEBYTE(p + 1)]);
+        break;
+    case OP_CAT:
+    case OP_CATN:
+    case OP_SCMP:
+        /* the helpers take the string count or comparison as their second argument */
+        MovImm(j, RSI, op == OP_CAT ? 2 : VMCODEBYTE(p + 1));
+        CallHelper(j, op == OP_SCMP ? (void *)StringCompare : (void *)StringCat);
+        break;
+    case OP_TCALL:
+        /* the helper returns the native code to jump to or NULL if the function has already run */
+        CallHelper(j, (void *)TailCallFromNative);
+        Reg(j, 1, 0x85, RAX, RAX);
+        Jcc(j, CC_NE, T_TAIL);
+        Jmp(j, T_EXIT);
+        break;
+    case OP_RETURN:
+    case OP_RETURNV:
+        /* pop the frame and push the return value onto the caller's stack */
+        if (op == OP_RETURN)
+            PopReg(j, RSAVE);
+        CallHelper(j, (void *)ReturnFromNative);
+        if (op == OP_RETURN) {
+            AddSP(j, RSTK, -(VMVALUE)sizeof(VMVALUE));
+            Mem(j, 0, 0x89, RSAVE, RSTK, 0);
+            Mem(j, 1, 0x89, RSTK, RI, offsetof(Interpreter, sp));
+        }
+        Jmp(j, T_EXIT);
+        break;
+    case OP_LITH:
+        if (fuseCall)
+            CallHelper(j, (void *)GetIntrinsicHandler(GetHandle(p + 1)));
+        else {
+            MovImm(j, RAX, GetWord(p + 1));
+            PushHandle(j, GetWord(p + 1) && !IsImmortal(GetHandle(p + 1)));
+        }
+        break;
+    case OP_GREFH:
+        LoadGlobal(j, RAX, GetWord(p + 1));
+        Mem(j, 1, 0x8b, RAX, RAX, offsetof(Symbol, v));
+        PushHandle(j, VMTRUE);
+        break;
+    case OP_LREFH:
+        Mem(j, 1, 0x8b, RAX, RI, offsetof(Interpreter, hfp));
+        Mem(j, 1, 0x8b, RAX, RAX, (int8_t)VMCODEBYTE(p + 1) * (VMVALUE)sizeof(VMHANDLE));
+        PushHandle(j, VMTRUE);
+        break;
+    case OP_LSETH:
+        MovImm(j, RSI, (int8_t)VMCODEBYTE(p + 1));
+        CallHelper(j, (void *)StoreHandleHelper);
+        break;
+    case OP_DROPH:
+        CallHelper(j, (void *)DropHandleHelper);
+        break;
+    }
+}
+
+/* ForTemplate - compile the start of a FOR loop */
+static void ForTemplate(JitState *j, int var, VMVALUE disp, int slot, VMVALUE target)
+{
+    uint8_t *negative, *done;
+    PopReg(j, RAX);
+    PopReg(j, RCX);
+    Mem(j, 0, 0x89, RAX, RFP, (slot - 1) * (VMVALUE)sizeof(VMVALUE));
+    Mem(j, 0, 0x89, RCX, RFP, slot * (VMVALUE)sizeof(VMVALUE));
+    Mem(j, 0, 0x8b, RDX, var, disp);
+    Reg(j, 0, 0x85, RAX, RAX);
+    negative = JccShort(j, CC_S);
+    Reg(j, 0, 0x39, RCX, RDX);
+    Jcc(j, CC_G, target);
+    done = JccShort(j, -1);
+    PatchShort(j, negative);
+    Reg(j, 0, 0x39, RCX, RDX);
+    Jcc(j, CC_L, target);
+    PatchShort(j, done);
+}
+
+/* NextTemplate - compile the end of a FOR loop */
+static void NextTemplate(JitState *j, int var, VMVALUE disp, int slot, VMVALUE target)
+{
+    uint8_t *negative, *done;
+    Mem(j, 0, 0x8b, RAX, RFP, (slot - 1) * (VMVALUE)sizeof(VMVALUE));
+    Mem(j, 0, 0x8b, RDX, var, disp);
+    Reg(j, 0, 0x01, RAX, RDX);
+    Mem(j, 0, 0x89, RDX, var, disp);
+    Reg(j, 0, 0x85, RAX, RAX);
+    negative = JccShort(j, CC_S);
+    Mem(j, 0, 0x3b, RDX, RFP, slot * (VMVALUE)sizeof(VMVALUE));
+    Jcc(j, CC_LE, target);
+    done = JccShort(j, -1);
+    PatchShort(j, negative);
+    Mem(j, 0, 0x3b, RDX, RFP, slot * (VMVALUE)sizeof(VMVALUE));
+    Jcc(j, CC_GE, target);
+    PatchShort(j, done);
+}
+
+/* DivTemplate - compile a divide leaving the quotient (RAX) or remainder (RDX) */
+static void DivTemplate(JitState *j, int result)
+{
+    uint8_t *zero, *done;
+    PopReg(j, RCX);
+    Reg(j, 0, 0x85, RCX, RCX);
+    zero = JccShort(j, CC_E);
+    Mem(j, 0, 0x8b, RAX, RSTK, 0);
+    Byte(j, 0x99);
+    Reg(j, 0, 0xf7, 7, RCX);
+    Mem(j, 0, 0x89, result, RSTK, 0);
+    done = JccShort(j, -1);
+    PatchShort(j, zero);
+    Mem(j, 0, 0xc7, 0, RSTK, 0);
+    Long(j, 0);
+    PatchShort(j, done);
+}
+
+/* CallHelper - call a C function with the interpreter state as its first argument */
+static void CallHelper(JitState *j, void *fcn)
+{
+    Mem(j, 1, 0x89, RSTK, RI, offsetof(Interpreter, sp));
+    Reg(j, 1, 0x89, RI, RDI);
+    Byte(j, 0x48); Byte(j, 0xb8);
+    memcpy(j->p, &fcn, sizeof(fcn));
+    j->p += sizeof(fcn);
+    Byte(j, 0xff); Byte(j, 0xd0);
+    Mem(j, 1, 0x8b, RSTK, RI, offsetof(Interpreter, sp));
+}
+
+/* PushReg - push a register onto the stack */
+static void PushReg(JitState *j, int reg)
+{
+    AddSP(j, RSTK, -(VMVALUE)sizeof(VMVALUE));
+    Mem(j, 0, 0x89, reg, RSTK, 0);
+}
+
+/* PushHandle - push the handle in RAX onto the handle stack and maybe add a reference
+ *
+ * The reference is only added at run time if the handle isn't NULL and
+ * the object isn't immortal. A literal handle known not to need one
+ * doesn't get the code for it at all.
+ */
+static void PushHandle(JitState *j, int addRef)
+{
+    uint8_t *skip, *skip2;
+    Mem(j, 1, 0x8b, RCX, RI, offsetof(Interpreter, hsp));
+    AddSP(j, RCX, sizeof(VMHANDLE));
+    Mem(j, 1, 0x89, RCX, RI, offsetof(Interpreter, hsp));
+    Mem(j, 1, 0x89, RAX, RCX, 0);
+    if (addRef) {
+        Reg(j, 1, 0x85, RAX, RAX);
+        skip = JccShort(j, CC_E);
+        Mem(j, 1, 0x8b, RDX, RAX, 0);
+        Mem(j, 0, 0xf6, 0, RDX, (int)offsetof(ObjHdr, flags) - (int)sizeof(ObjHdr));
+        Byte(j, OBJ_IMMORTAL);
+        skip2 = JccShort(j, CC_NE);
+        Mem(j, 0, 0xff, 0, RDX, (int)offsetof(ObjHdr, refCnt) - (int)sizeof(ObjHdr));
+        PatchShort(j, skip);
+        PatchShort(j, skip2);
+    }
+}
+
+/* PopReg - pop the top of the stack into a register */
+static void PopReg(JitState *j, int reg)
+{
+    Mem(j, 0, 0x8b, reg, RSTK, 0);
+    AddSP(j, RSTK, sizeof(VMVALUE));
+}
+
+/* AddSP - add a constant to a pointer register */
+static void AddSP(JitState *j, int reg, VMVALUE n)
+{
+    if (n >= -128 && n < 128) {
+        Reg(j, 1, 0x83, 0, reg);
+        Byte(j, n);
+    }
+    else {
+        Reg(j, 1, 0x81, 0, reg);
+        Long(j, n);
+    }
+}
+
+/* LoadGlobal - load the address of a global symbol into a register */
+static void LoadGlobal(JitState *j, int reg, VMVALUE symbol)
+{
+    MovImm(j, reg, symbol);
+    Mem(j, 1, 0x8b, reg, reg, 0);
+}
+
+/* Jcc - emit a conditional branch to a bytecode offset or special target */
+static void Jcc(JitState *j, int cc, VMVALUE target)
+{
+    Byte(j, 0x0f);
+    Byte(j, 0x80 + cc);
+    j->fixups[2 * j->fixupCount] = j->p - j->code;
+    j->fixups[2 * j->fixupCount + 1] = target;
+    ++j->fixupCount;
+    Long(j, 0);
+}
+
+/* Jmp - emit an unconditional branch to a bytecode offset or special target */
+static void Jmp(JitState *j, VMVALUE target)
+{
+    Byte(j, 0xe9);
+    j->fixups[2 * j->fixupCount] = j->p - j->code;
+    j->fixups[2 * j->fixupCount + 1] = target;
+    ++j->fixupCount;
+    Long(j, 0);
+}
+
+/* JccShort - emit a short forward branch within a template (cc -1 is unconditional) */
+static uint8_t *JccShort(JitState *j, int cc)
+{
+    Byte(j, cc < 0 ? 0xeb : 0x70 + cc);
+    Byte(j, 0);
+    return j->p - 1;
+}
+
+/* PatchShort - point a short branch at the current location */
+static void PatchShort(JitState *j, uint8_t *patch)
+{
+    *patch = (uint8_t)(j->p - patch - 1);
+}
+
+/* Mem - emit an instruction with a register and a base plus displacement operand */
+static void Mem(JitState *j, int w, int op, int reg, int base, VMVALUE disp)
+{
+    int rex = 0x40 | (w ? 8 : 0) | ((reg & 8) >> 1) | ((base & 8) >> 3);
+    int mod = (disp == 0 && (base & 7) != RBP ? 0 : disp >= -128 && disp < 128 ? 1 : 2);
+    if (rex != 0x40)
+        Byte(j, rex);
+    if (op > 0xff)
+        Byte(j, op >> 8);
+    Byte(j, op);
+    Byte(j, (mod << 6) | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == RSP)
+        Byte(j, 0x24);
+    if (mod == 1)
+        Byte(j, disp);
+    else if (mod == 2)
+        Long(j, disp);
+}
+
+/* Reg - emit an instruction with two register operands */
+static void Reg(JitState *j, int w, int op, int reg, int rm)
+{
+    int rex = 0x40 | (w ? 8 : 0) | ((reg & 8) >> 1) | ((rm & 8) >> 3);
+    if (rex != 0x40)
+        Byte(j, rex);
+    Byte(j, op);
+    Byte(j, 0xc0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+/* MovImm - load a 32 bit value into a register zero extending it */
+static void MovImm(JitState *j, int reg, VMVALUE value)
+{
+    if (reg & 8)
+        Byte(j, 0x41);
+    Byte(j, 0xb8 + (reg & 7));
+    Long(j, value);
+}
+
+/* PushNative - push a register onto the native stack */
+static void PushNative(JitState *j, int reg)
+{
+    if (reg & 8)
+        Byte(j, 0x41);
+    Byte(j, 0x50 + (reg & 7));
+}
+
+/* PopNative - pop a register from the native stack */
+static void PopNative(JitState *j, int reg)
+{
+    if (reg & 8)
+        Byte(j, 0x41);
+    Byte(j, 0x58 + (reg & 7));
+}
+
+/* Long - emit a 32 bit value */
+static void Long(JitState *j, VMVALUE value)
+{
+    memcpy(j->p, &value, sizeof(VMVALUE));
+    j->p += sizeof(VMVALUE);
+}
+
+/* GetWord - get a word operand from the bytecode */
+static VMVALUE GetWord(uint8_t *p)
+{
+    VMVALUE value;
+    get_VMVALUE(value, VMCODEBYTE(p++));
+    return value;
+}
+
+/* BranchTarget - get the bytecode offset of the target of a branch instruction */
+static VMVALUE BranchTarget(uint8_t *base, uint8_t *p)
+{
+    p += InstructionSize(VMCODEBYTE(p));
+    return p - base + GetWord(p - sizeof(VMVALUE));
+}
+
+/* DropHandleHelper - drop the top of the handle stack */
+static void DropHandleHelper(Interpreter *i)
+{
+    ObjRelease(i->heap, *i->hsp);
+    DropH(i, 1);
+}
+
+/* StoreHandleHelper - store the top of the handle stack in a handle local */
+static void StoreHandleHelper(Interpreter *i, int offset)
+{
+    ObjRelease(i->heap, i->hfp[offset]);
+    i->hfp[offset] = PopH(i);
+}
+
+#endif
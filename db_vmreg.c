@@ -0,0 +1,552 @@
+/* db_vmreg.c - translate stack code into register code
+ *
+ * Copyright (c) 2012 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+/* With REGISTER_VM defined each code object is translated into register code
+ * when it is pre-decoded. The values the stack code would push are tracked
+ * in a virtual stack while translating. Locals, globals and literals are left
+ * in place until they are used so "a = b + 1" becomes a single R_ADD that
+ * reads b and writes a directly. Other results go in temporaries just below
+ * sp. The virtual stack is written out to the real stack at branch targets
+ * and before any instruction that needs its operands on the real stack,
+ * like a call, which is then copied through unchanged.
+ *
+ * The translation is done here rather than in the compiler because the
+ * stack effect of a call isn't known until the callee has been compiled.
+ */
+
+#include <string.h>
+#include "db_vm.h"
+
+#ifdef REGISTER_VM
+
+/* marks a byte offset that is a branch target in the index */
+#define NOT_LEADER      -1
+
+/* room needed to translate a single instruction */
+#define MAXENTRIES      (STACK_SLACK * 4 + 8)
+
+/* translation state */
+typedef struct {
+    uint8_t *base;                  /* bytecode being translated */
+    VMVALUE *index;                 /* bytecode offset to register code index */
+    VMVALUE *fixups;                /* entries holding bytecode branch targets */
+    int fixupCount;
+    Instr *code;                    /* register code */
+    Instr *ip;                      /* next free register code entry */
+    Instr *lastOp;                  /* last operator if its result is on top */
+    VMVALUE stack[STACK_SLACK];     /* virtual stack operands */
+    int count;                      /* number of virtual stack entries */
+    int popped;                     /* real stack values used since the last sync */
+} Translator;
+
+/* virtual stack operand helpers */
+#define IsImmediate(o)  (((o) & 3) == R_IMMEDIATE)
+#define IsTemp(o)       (((o) & 3) == R_TEMP)
+#define ImmediateValue(o)   ((o) >> 2)
+#define Home(t, r)      RegOperand(R_TEMP, (t)->popped - 1 - (r))
+
+/* prototypes for local functions */
+static VMVALUE GetWord(uint8_t *p);
+static VMVALUE BranchTarget(Translator *t, uint8_t *p);
+static void Emit(Translator *t, int opcode, VMVALUE operand);
+static void EmitOperand(Translator *t, VMVALUE operand);
+static void EmitBranch(Translator *t, int opcode, VMVALUE target);
+static void PushOperand(Translator *t, VMVALUE operand);
+static void PushLiteral(Translator *t, VMVALUE value);
+static VMVALUE PopOperand(Translator *t);
+static void UnaryOp(Translator *t, int op);
+static void BinaryOp(Translator *t, int op);
+static void Store(Translator *t, VMVALUE dst);
+static void Materialize(Translator *t, int r);
+static int Sync(Translator *t);
+static void ConditionalBranch(Translator *t, int opcode, VMVALUE target);
+static void CompareAndBranch(Translator *t, int op, VMVALUE target);
+static int FoldUnary(int op, VMVALUE a, VMVALUE *pValue);
+static int FoldBinary(int op, VMVALUE a, VMVALUE b, VMVALUE *pValue);
+static int FoldCompare(int op, VMVALUE a, VMVALUE b);
+
+/* TranslateCode - translate a single code object into register code */
+Instr *TranslateCode(Interpreter *i, VMHANDLE code)
+{
+    uint8_t *base = GetCodePtr(code);
+    uint8_t *end = base + GetHeapObjSize(code);
+    int len = end - base;
+    Translator state, *t = &state;
+    Instr *limit;
+    uint8_t *p;
+    int op, n;
+
+    /* use the top of free space for the index and the fixup list */
+    t->base = base;
+    t->index = (VMVALUE *)i->sys->freeTop - (len + 1);
+    t->fixups = t->index - len;
+    t->fixupCount = 0;
+
+    /* the register code goes at the bottom of free space */
+    t->code = t->ip = (Instr *)i->sys->freeNext;
+    limit = (Instr *)t->fixups;
+    t->lastOp = NULL;
+    t->count = t->popped = 0;
+
+    /* find the branch targets */
+    for (n = 0; n <= len; ++n)
+        t->index[n] = NOT_LEADER;
+    for (p = base; p < end; p += InstructionSize(op)) {
+        switch (op = VMCODEBYTE(p)) {
+        case OP_BRT:
+        case OP_BRTSC:
+        case OP_BRF:
+        case OP_BRFSC:
+        case OP_BR:
+        case OP_BRLT:
+        case OP_BRLE:
+        case OP_BREQ:
+        case OP_BRNE:
+        case OP_BRGE:
+        case OP_BRGT:
+        case OP_LBRLT:
+        case OP_LBRLE:
+        case OP_LBREQ:
+        case OP_LBRNE:
+        case OP_LBRGE:
+        case OP_LBRGT:
+        case OP_FORL:
+        case OP_NEXTL:
+        case OP_FORG:
+        case OP_NEXTG:
+            t->index[BranchTarget(t, p)] = 0;
+            break;
+        }
+    }
+
+    /* translate the instructions */
+    for (p = base; ; p += InstructionSize(op)) {
+
+        /* branch targets start with an empty virtual stack */
+        if (t->index[p - base] != NOT_LEADER) {
+            Sync(t);
+            t->index[p - base] = t->ip - t->code;
+        }
+        if (p >= end)
+            break;
+
+        /* make sure there is room for the worst case */
+        if (t->ip + MAXENTRIES > limit)
+            return NULL;
+
+        switch (op = VMCODEBYTE(p)) {
+        case OP_NOT:
+        case OP_NEG:
+        case OP_BNOT:
+            UnaryOp(t, op);
+            break;
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_REM:
+        case OP_BAND:
+        case OP_BOR:
+        case OP_BXOR:
+        case OP_SHL:
+        case OP_SHR:
+        case OP_LT:
+        case OP_LE:
+        case OP_EQ:
+        case OP_NE:
+        case OP_GE:
+        case OP_GT:
+            BinaryOp(t, op);
+            break;
+        case OP_LIT:
+            PushLiteral(t, GetWord(p + 1));
+            break;
+        case OP_GREF:
+            PushOperand(t, GlobalOperand(GetWord(p + 1)));
+            break;
+        case OP_GSET:
+            Store(t, GlobalOperand(GetWord(p + 1)));
+            break;
+        case OP_LREF:
+            PushOperand(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            break;
+        case OP_LSET:
+            Store(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            break;
+        case OP_LTEE:
+            Store(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            PushOperand(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            break;
+        case OP_LREF2:
+            PushOperand(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            PushOperand(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 2)));
+            break;
+        case OP_ADDI:
+            PushLiteral(t, GetWord(p + 1));
+            BinaryOp(t, OP_ADD);
+            break;
+        case OP_LINC:
+            PushOperand(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            PushLiteral(t, GetWord(p + 2));
+            BinaryOp(t, OP_ADD);
+            Store(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            break;
+        case OP_DROP:
+            PopOperand(t);
+            t->lastOp = NULL;
+            break;
+        case OP_BR:
+            Sync(t);
+            EmitBranch(t, OP_BR, BranchTarget(t, p));
+            break;
+        case OP_BRT:
+            ConditionalBranch(t, R_BRT, BranchTarget(t, p));
+            break;
+        case OP_BRF:
+            ConditionalBranch(t, R_BRF, BranchTarget(t, p));
+            break;
+        case OP_BRTSC:
+        case OP_BRFSC:
+            /* the value is left on the stack if the branch is taken */
+            Sync(t);
+            Emit(t, op == OP_BRTSC ? R_BRT : R_BRF, RegOperand(R_TEMP, 0));
+            EmitBranch(t, -1, BranchTarget(t, p));
+            t->popped = 1;
+            break;
+        case OP_BRLT:
+        case OP_BRLE:
+        case OP_BREQ:
+        case OP_BRNE:
+        case OP_BRGE:
+        case OP_BRGT:
+            CompareAndBranch(t, op - OP_BRLT, BranchTarget(t, p));
+            break;
+        case OP_LBRLT:
+        case OP_LBRLE:
+        case OP_LBREQ:
+        case OP_LBRNE:
+        case OP_LBRGE:
+        case OP_LBRGT:
+            PushOperand(t, RegOperand(R_LOCAL, (int8_t)VMCODEBYTE(p + 1)));
+            PushLiteral(t, GetWord(p + 2));
+            CompareAndBranch(t, op - OP_LBRLT, BranchTarget(t, p));
+            break;
+        case OP_LITH:
+        case OP_GREFH:
+        case OP_GSETH:
+        case OP_LREFH:
+        case OP_LSETH:
+        case OP_GAPPH:
+        case OP_LAPPH:
+        case OP_DROPH:
+        case OP_CAT:
+        case OP_CATN:
+            /* these only use the handle stack */
+            t->ip = DecodeInstr(t->ip, base, p, NULL);
+            break;
+        default:
+            /* everything else uses the real stack */
+            Sync(t);
+            t->ip = DecodeInstr(t->ip, base, p, NULL);
+            switch (op) {
+            case OP_FORL:
+            case OP_NEXTL:
+            case OP_FORG:
+            case OP_NEXTG:
+                t->fixups[t->fixupCount++] = t->ip - t->code - 1;
+                break;
+            }
+            break;
+        }
+    }
+
+    /* replace the bytecode branch targets with register code indexes */
+    for (n = 0; n < t->fixupCount; ++n)
+        t->code[t->fixups[n]].operand = t->index[t->code[t->fixups[n]].operand];
+
+    /* allocate the register code */
+    if (!AllocateFreeSpace(i->sys, (t->ip - t->code) * sizeof(Instr)))
+        return NULL;
+    i->decodedTop = t->ip;
+
+    return t->code;
+}
+
+/* GetWord - get a word operand from the bytecode */
+static VMVALUE GetWord(uint8_t *p)
+{
+    VMVALUE value;
+    get_VMVALUE(value, VMCODEBYTE(p++));
+    return value;
+}
+
+/* BranchTarget - get the bytecode offset of the target of a branch instruction */
+static VMVALUE BranchTarget(Translator *t, uint8_t *p)
+{
+    p += InstructionSize(VMCODEBYTE(p));
+    return p - t->base + GetWord(p - sizeof(VMVALUE));
+}
+
+/* Emit - emit an instruction */
+static void Emit(Translator *t, int opcode, VMVALUE operand)
+{
+    t->ip->op.opcode = opcode;
+    t->ip->operand = operand;
+    ++t->ip;
+}
+
+/* EmitOperand - emit an additional operand for the last instruction */
+static void EmitOperand(Translator *t, VMVALUE operand)
+{
+    Emit(t, OP_HALT, operand);
+}
+
+/* EmitBranch - emit a branch instruction or the target operand of one */
+static void EmitBranch(Translator *t, int opcode, VMVALUE target)
+{
+    if (opcode >= 0)
+        Emit(t, opcode, target);
+    else
+        EmitOperand(t, target);
+    t->fixups[t->fixupCount++] = t->ip - t->code - 1;
+}
+
+/* PushOperand - push an operand onto the virtual stack */
+static void PushOperand(Translator *t, VMVALUE operand)
+{
+    if (t->count >= STACK_SLACK)
+        Sync(t);
+    t->stack[t->count++] = operand;
+    t->lastOp = NULL;
+}
+
+/* PushLiteral - push a literal value onto the virtual stack */
+static void PushLiteral(Translator *t, VMVALUE value)
+{
+    VMVALUE dst;
+    if (FitsImmediate(value))
+        PushOperand(t, RegOperand(R_IMMEDIATE, value));
+    else {
+        if (t->count >= STACK_SLACK)
+            Sync(t);
+        dst = Home(t, t->count);
+        Emit(t, R_LI, dst);
+        EmitOperand(t, value);
+        PushOperand(t, dst);
+    }
+}
+
+/* PopOperand - pop an operand from the virtual stack or from the real stack if it is empty */
+static VMVALUE PopOperand(Translator *t)
+{
+    if (t->count > 0)
+        return t->stack[--t->count];
+    return RegOperand(R_TEMP, t->popped++);
+}
+
+/* UnaryOp - translate a unary operator */
+static void UnaryOp(Translator *t, int op)
+{
+    VMVALUE a, value;
+    Instr *ip;
+    
+    a = PopOperand(t);
+    if (IsImmediate(a) && FoldUnary(op, ImmediateValue(a), &value))
+        PushLiteral(t, value);
+    else {
+        ip = t->ip;
+        Emit(t, R_OP + op, Home(t, t->count));
+        EmitOperand(t, a);
+        t->stack[t->count++] = ip->operand;
+        t->lastOp = ip;
+    }
+}
+
+/* BinaryOp - translate a binary operator */
+static void BinaryOp(Translator *t, int op)
+{
+    VMVALUE a, b, value;
+    Instr *ip;
+    
+    b = PopOperand(t);
+    a = PopOperand(t);
+    if (IsImmediate(a) && IsImmediate(b) && FoldBinary(op, ImmediateValue(a), ImmediateValue(b), &value))
+        PushLiteral(t, value);
+    else {
+        ip = t->ip;
+        Emit(t, R_OP + op, Home(t, t->count));
+        EmitOperand(t, a);
+        EmitOperand(t, b);
+        t->stack[t->count++] = ip->operand;
+        t->lastOp = ip;
+    }
+}
+
+/* Store - translate a store into a local or global variable */
+static void Store(Translator *t, VMVALUE dst)
+{
+    VMVALUE value = PopOperand(t);
+    int r;
+
+    /* look for values on the virtual stack that are still the old value of the variable */
+    for (r = 0; r < t->count; ++r)
+        if (t->stack[r] == dst)
+            break;
+
+    /* have the operator that computed the value store it directly if possible */
+    if (t->lastOp && t->lastOp->operand == value && r >= t->count)
+        t->lastOp->operand = dst;
+    else if (value != dst) {
+        for (; r < t->count; ++r)
+            if (t->stack[r] == dst)
+                Materialize(t, r);
+        Emit(t, R_MOV, dst);
+        EmitOperand(t, value);
+    }
+    t->lastOp = NULL;
+}
+
+/* Materialize - copy a virtual stack entry into its stack temporary */
+static void Materialize(Translator *t, int r)
+{
+    VMVALUE dst = Home(t, r);
+    if (t->stack[r] != dst) {
+        Emit(t, R_MOV, dst);
+        EmitOperand(t, t->stack[r]);
+        t->stack[r] = dst;
+    }
+}
+
+/* Sync - make the real stack match the virtual stack and return how far sp moved */
+static int Sync(Translator *t)
+{
+    int r, n;
+    for (r = 0; r < t->count; ++r)
+        Materialize(t, r);
+    if ((n = t->count - t->popped) != 0)
+        Emit(t, R_ADJSP, n);
+    t->count = t->popped = 0;
+    t->lastOp = NULL;
+    return n;
+}
+
+/* ConditionalBranch - translate a branch on true or false */
+static void ConditionalBranch(Translator *t, int opcode, VMVALUE target)
+{
+    VMVALUE a = PopOperand(t);
+    int n = Sync(t);
+    if (IsTemp(a))
+        a += n * 4;
+    if (!IsImmediate(a)) {
+        Emit(t, opcode, a);
+        EmitBranch(t, -1, target);
+    }
+    else if ((ImmediateValue(a) != 0) == (opcode == R_BRT))
+        EmitBranch(t, OP_BR, target);
+}
+
+/* CompareAndBranch - translate a compare and branch where cmp is the offset from OP_LT */
+static void CompareAndBranch(Translator *t, int cmp, VMVALUE target)
+{
+    VMVALUE b = PopOperand(t);
+    VMVALUE a = PopOperand(t);
+    int n = Sync(t);
+    if (IsTemp(a))
+        a += n * 4;
+    if (IsTemp(b))
+        b += n * 4;
+    if (!IsImmediate(a) || !IsImmediate(b)) {
+        Emit(t, R_BRLT + cmp, a);
+        EmitOperand(t, b);
+        EmitBranch(t, -1, target);
+    }
+    else if (FoldCompare(OP_LT + cmp, ImmediateValue(a), ImmediateValue(b)))
+        EmitBranch(t, OP_BR, target);
+}
+
+/* FoldUnary - compute the value of a unary operator with a literal operand */
+static int FoldUnary(int op, VMVALUE a, VMVALUE *pValue)
+{
+    switch (op) {
+    case OP_NOT:
+        *pValue = (a ? VMFALSE : VMTRUE);
+        break;
+    case OP_NEG:
+        *pValue = -a;
+        break;
+    case OP_BNOT:
+        *pValue = ~a;
+        break;
+    default:
+        return VMFALSE;
+    }
+    return VMTRUE;
+}
+
+/* FoldBinary - compute the value of a binary operator with literal operands
+ *
+ * The operands fit in an immediate operand so only multiplies and left shifts
+ * can overflow. Those are done unsigned to get the same wraparound as the
+ * interpreter. Shifts by out of range counts are left for run time.
+ */
+static int FoldBinary(int op, VMVALUE a, VMVALUE b, VMVALUE *pValue)
+{
+    switch (op) {
+    case OP_ADD:
+        *pValue = a + b;
+        break;
+    case OP_SUB:
+        *pValue = a - b;
+        break;
+    case OP_MUL:
+        *pValue = (VMVALUE)((VMUVALUE)a * (VMUVALUE)b);
+        break;
+    case OP_DIV:
+        *pValue = (b == 0 ? 0 : a / b);
+        break;
+    case OP_REM:
+        *pValue = (b == 0 ? 0 : a % b);
+        break;
+    case OP_BAND:
+        *pValue = a & b;
+        break;
+    case OP_BOR:
+        *pValue = a | b;
+        break;
+    case OP_BXOR:
+        *pValue = a ^ b;
+        break;
+    case OP_SHL:
+        if (b < 0 || b >= (VMVALUE)(sizeof(VMVALUE) * 8))
+            return VMFALSE;
+        *pValue = (VMVALUE)((VMUVALUE)a << b);
+        break;
+    case OP_SHR:
+        if (b < 0 || b >= (VMVALUE)(sizeof(VMVALUE) * 8))
+            return VMFALSE;
+        *pValue = a >> b;
+        break;
+    default:
+        *pValue = (FoldCompare(op, a, b) ? VMTRUE : VMFALSE);
+        break;
+    }
+    return VMTRUE;
+}
+
+/* FoldCompare - compare two literal values */
+static int FoldCompare(int op, VMVALUE a, VMVALUE b)
+{
+    switch (op) {
+    case OP_LT: return a < b;
+    case OP_LE: return a <= b;
+    case OP_EQ: return a == b;
+    case OP_NE: return a != b;
+    case OP_GE: return a >= b;
+    default:    return a > b;
+    }
+}
+
+#endif
@@ -0,0 +1,520 @@
+/* db_vmverify.c - bytecode verifier
+ *
+ * Copyright (c) 2012 by David Michael Betz.  All rights reserved.
+ *
+ */
+
+/* With UNCHECKED defined the compiler runs each code object through the
+ * verifier as it is stored and the interpreter leaves out the runtime checks
+ * that verified code can't fail. The verifier follows every path through the
+ * code counting the values and handles on the two stacks and checks that:
+ *
+ *  - every reachable opcode is defined and no instruction runs off the end
+ *  - branches land on the start of an instruction
+ *  - the stacks have the same depths on every path into an instruction
+ *  - nothing pops a value or handle that isn't there
+ *  - the stacks never get deeper than the frame descriptor says
+ *  - locals and arguments are inside the frame and globals are symbols
+ *  - calls are to known functions or intrinsics with their arguments on the stacks
+ *
+ * The depth limit is what makes the single stack check in StartCode safe.
+ */
+
+#include <string.h>
+#include "db_vm.h"
+
+#ifdef UNCHECKED
+
+/* instruction flags */
+#define V_START         0x01        /* start of an instruction */
+
+/* depth of an instruction that hasn't been reached yet */
+#define UNREACHED       -1
+
+/* get a local operand */
+#define LocalOperand(p) ((int8_t)VMCODEBYTE(p))
+
+/* verifier state */
+typedef struct {
+    ObjHeap *heap;
+    uint8_t *base;                  /* code being verified */
+    int len;                        /* length of the code */
+    uint8_t *flags;                 /* instruction flags indexed by offset */
+    int16_t *depths;                /* value and handle depths indexed by offset */
+    int locals;                     /* value locals from the frame descriptor */
+    int handleLocals;               /* handle locals from the frame descriptor */
+    int maxDepth;                   /* most values from the frame descriptor */
+    int maxHandleDepth;             /* most handles from the frame descriptor */
+    int args;                       /* value arguments */
+    int handleArgs;                 /* handle arguments */
+    int returnOp;                   /* return opcode or OP_HALT for the main code */
+    int depth;                      /* values on the stack */
+    int handleDepth;                /* handles on the stack */
+    int changed;                    /* an instruction already passed was reached */
+    int offset;                     /* instruction being verified */
+    char *error;                    /* the problem with it */
+} Verifier;
+
+/* prototypes for local functions */
+static int VerifyInstr(Verifier *v, uint8_t *p);
+static int Reach(Verifier *v, int target);
+static int Branch(Verifier *v, uint8_t *p);
+static int PopDepth(Verifier *v, int values, int handles);
+static int PushDepth(Verifier *v, int values, int handles);
+static int Call(Verifier *v, Type *type, int handles);
+static int TailCall(Verifier *v, Type *type);
+static int Return(Verifier *v, uint8_t *p);
+static int CheckLocal(Verifier *v, int offset);
+static int CheckSlot(Verifier *v, int offset);
+static int CheckHandleLocal(Verifier *v, int offset);
+static int CheckGlobal(Verifier *v, uint8_t *p, int handle);
+static int Fail(Verifier *v, char *error);
+static Type *FindFunction(ObjHeap *heap, VMHANDLE fcn);
+static Type *FindIntrinsic(ObjHeap *heap, int index);
+static void CountArguments(Type *type, int *pArgs, int *pHandleArgs);
+static int ReturnOpcode(Type *type);
+static int IsObject(ObjHeap *heap, VMHANDLE h);
+static VMVALUE GetWord(uint8_t *p);
+
+/* VerifyCode - verify a code object
+ *
+ * The scratch space needs three bytes for each byte of code. The return
+ * value is NULL if the code is good or a description of the first problem
+ * found in which case *pOffset is the offset of the instruction.
+ */
+char *VerifyCode(ObjHeap *heap, VMHANDLE code, uint8_t *scratch, uint8_t *scratchTop, int *pOffset)
+{
+    Verifier state, *v = &state;
+    uint8_t *p, *end;
+    Type *type;
+    int op, n;
+
+    /* setup the verifier state */
+    v->heap = heap;
+    v->base = GetCodePtr(code);
+    v->len = GetHeapObjSize(code);
+    v->offset = 0;
+    end = v->base + v->len;
+
+    /* use the scratch space for the depths and flags */
+    v->depths = (int16_t *)scratch;
+    v->flags = (uint8_t *)(v->depths + 2 * v->len);
+    if (v->flags + v->len > scratchTop) {
+        *pOffset = 0;
+        return "insufficient memory";
+    }
+    memset(v->flags, 0, v->len);
+    for (n = 0; n < 2 * v->len; ++n)
+        v->depths[n] = UNREACHED;
+
+    /* the code starts with its frame descriptor */
+    if (v->len < InstructionSize(OP_RESERVE) || VMCODEBYTE(v->base) != OP_RESERVE) {
+        *pOffset = 0;
+        return "missing RESERVE";
+    }
+    v->locals = VMCODEBYTE(v->base + FD_LOCALS);
+    v->handleLocals = VMCODEBYTE(v->base + FD_HLOCALS);
+    v->maxDepth = VMCODEBYTE(v->base + FD_DEPTH);
+    v->maxHandleDepth = VMCODEBYTE(v->base + FD_HDEPTH);
+
+    /* functions get their arguments from their type, the main code has none */
+    if ((type = FindFunction(heap, code)) != NULL) {
+        CountArguments(type, &v->args, &v->handleArgs);
+        v->returnOp = ReturnOpcode(type);
+    }
+    else {
+        v->args = v->handleArgs = 0;
+        v->returnOp = OP_HALT;
+    }
+
+    /* the returns pop the arguments the frame descriptor says there are */
+    if (VMCODEBYTE(v->base + FD_ARGS) != v->args || VMCODEBYTE(v->base + FD_HARGS) != v->handleArgs) {
+        *pOffset = 0;
+        return "wrong number of arguments";
+    }
+
+    /* find the start of each instruction but a call goes with the LITH before it */
+    for (p = v->base, op = OP_HALT; p < end; p += n) {
+        n = InstructionSize(VMCODEBYTE(p));
+        if (p + n > end) {
+            *pOffset = p - v->base;
+            return "instruction runs off the end of the code";
+        }
+        if ((VMCODEBYTE(p) != OP_CALL && VMCODEBYTE(p) != OP_TCALL) || op != OP_LITH)
+            v->flags[p - v->base] = V_START;
+        op = VMCODEBYTE(p);
+    }
+
+    /* the frame descriptor is only at the start */
+    v->flags[0] = 0;
+    v->depth = v->handleDepth = 0;
+    if (!Reach(v, InstructionSize(OP_RESERVE))) {
+        *pOffset = v->offset;
+        return v->error;
+    }
+
+    /* follow the paths through the code until the depths stop changing */
+    do {
+        v->changed = VMFALSE;
+        for (p = v->base; p < end; p += InstructionSize(VMCODEBYTE(p))) {
+            n = p - v->base;
+            if (v->depths[2 * n] != UNREACHED && !VerifyInstr(v, p)) {
+                *pOffset = v->offset;
+                return v->error;
+            }
+        }
+    } while (v->changed);
+
+    return NULL;
+}
+
+/* VerifyInstr - verify a single instruction and pass its depths on to the instructions that follow it */
+static int VerifyInstr(Verifier *v, uint8_t *p)
+{
+    int op = VMCODEBYTE(p);
+    int next;
+
+    v->offset = p - v->base;
+    v->depth = v->depths[2 * v->offset];
+    v->handleDepth = v->depths[2 * v->offset + 1];
+    next = v->offset + InstructionSize(op);
+
+    switch (op) {
+    case OP_HALT:
+        return VMTRUE;
+    case OP_BR:
+        return Branch(v, p);
+    case OP_BRT:
+    case OP_BRF:
+        return PopDepth(v, 1, 0) && Branch(v, p) && Reach(v, next);
+    case OP_BRTSC:
+    case OP_BRFSC:
+        /* the value stays on the stack if the branch is taken */
+        return PopDepth(v, 1, 0) && PushDepth(v, 1, 0) && Branch(v, p) && PopDepth(v, 1, 0) && Reach(v, next);
+    case OP_NOT:
+    case OP_NEG:
+    case OP_BNOT:
+    case OP_ADDI:
+        return PopDepth(v, 1, 0) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_ADD:
+    case OP_SUB:
+    case OP_MUL:
+    case OP_DIV:
+    case OP_REM:
+    case OP_BAND:
+    case OP_BOR:
+    case OP_BXOR:
+    case OP_SHL:
+    case OP_SHR:
+    case OP_LT:
+    case OP_LE:
+    case OP_EQ:
+    case OP_NE:
+    case OP_GE:
+    case OP_GT:
+        return PopDepth(v, 2, 0) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_CAT:
+        return PopDepth(v, 0, 2) && PushDepth(v, 0, 1) && Reach(v, next);
+    case OP_CATN:
+        return VMCODEBYTE(p + 1) >= 2 && VMCODEBYTE(p + 1) <= 127
+            && PopDepth(v, 0, VMCODEBYTE(p + 1)) && PushDepth(v, 0, 1) && Reach(v, next);
+    case OP_SCMP:
+        return VMCODEBYTE(p + 1) >= OP_LT && VMCODEBYTE(p + 1) <= OP_GT
+            && PopDepth(v, 0, 2) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_LIT:
+        return PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_GREF:
+        return CheckGlobal(v, p + 1, VMFALSE) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_GSET:
+        return CheckGlobal(v, p + 1, VMFALSE) && PopDepth(v, 1, 0) && Reach(v, next);
+    case OP_LREF:
+        return CheckLocal(v, LocalOperand(p + 1)) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_LSET:
+        return CheckLocal(v, LocalOperand(p + 1)) && PopDepth(v, 1, 0) && Reach(v, next);
+    case OP_LTEE:
+        return CheckLocal(v, LocalOperand(p + 1)) && PopDepth(v, 1, 0) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_LREF2:
+        return CheckLocal(v, LocalOperand(p + 1)) && CheckLocal(v, LocalOperand(p + 2)) && PushDepth(v, 2, 0) && Reach(v, next);
+    case OP_LINC:
+        return CheckLocal(v, LocalOperand(p + 1)) && Reach(v, next);
+    case OP_VREF:
+    case OP_VREFU:
+        return PopDepth(v, 1, 1) && PushDepth(v, 1, 0) && Reach(v, next);
+    case OP_VSET:
+    case OP_VSETU:
+        return PopDepth(v, 2, 1) && Reach(v, next);
+    case OP_DROP:
+        return PopDepth(v, 1, 0) && Reach(v, next);
+    case OP_BRLT:
+    case OP_BRLE:
+    case OP_BREQ:
+    case OP_BRNE:
+    case OP_BRGE:
+    case OP_BRGT:
+        return PopDepth(v, 2, 0) && Branch(v, p) && Reach(v, next);
+    case OP_LBRLT:
+    case OP_LBRLE:
+    case OP_LBREQ:
+    case OP_LBRNE:
+    case OP_LBRGE:
+    case OP_LBRGT:
+        return CheckLocal(v, LocalOperand(p + 1)) && Branch(v, p) && Reach(v, next);
+    case OP_FORL:
+        /* the limit and step are popped into the slot and the one below it */
+        return CheckLocal(v, LocalOperand(p + 1)) && CheckSlot(v, LocalOperand(p + 2)) && PopDepth(v, 2, 0) && Branch(v, p) && Reach(v, next);
+    case OP_NEXTL:
+        return CheckLocal(v, LocalOperand(p + 1)) && CheckSlot(v, LocalOperand(p + 2)) && Branch(v, p) && Reach(v, next);
+    case OP_FORG:
+        return CheckGlobal(v, p + 1, VMFALSE) && CheckSlot(v, LocalOperand(p + 1 + sizeof(VMVALUE))) && PopDepth(v, 2, 0)
+            && Branch(v, p) && Reach(v, next);
+    case OP_NEXTG:
+        return CheckGlobal(v, p + 1, VMFALSE) && CheckSlot(v, LocalOperand(p + 1 + sizeof(VMVALUE)))
+            && Branch(v, p) && Reach(v, next);
+    case OP_LITH:
+        /* the function being called is always a literal */
+        if (next < v->len && VMCODEBYTE(v->base + next) == OP_CALL)
+            return PushDepth(v, 0, 1) && Call(v, FindFunction(v->heap, ValueToHandle(GetWord(p + 1))), 1)
+                && Reach(v, next + InstructionSize(OP_CALL));
+        if (next < v->len && VMCODEBYTE(v->base + next) == OP_TCALL)
+            return PushDepth(v, 0, 1) && TailCall(v, FindFunction(v->heap, ValueToHandle(GetWord(p + 1))));
+        if (GetWord(p + 1) && !IsObject(v->heap, ValueToHandle(GetWord(p + 1))))
+            return Fail(v, "bad handle");
+        return PushDepth(v, 0, 1) && Reach(v, next);
+    case OP_GREFH:
+        return CheckGlobal(v, p + 1, VMTRUE) && PushDepth(v, 0, 1) && Reach(v, next);
+    case OP_GSETH:
+    case OP_GAPPH:
+        return CheckGlobal(v, p + 1, VMTRUE) && PopDepth(v, 0, 1) && Reach(v, next);
+    case OP_LREFH:
+        return CheckHandleLocal(v, LocalOperand(p + 1)) && PushDepth(v, 0, 1) && Reach(v, next);
+    case OP_LSETH:
+    case OP_LAPPH:
+        return CheckHandleLocal(v, LocalOperand(p + 1)) && PopDepth(v, 0, 1) && Reach(v, next);
+    case OP_VREFH:
+        return PopDepth(v, 1, 1) && PushDepth(v, 0, 1) && Reach(v, next);
+    case OP_VSETH:
+        return PopDepth(v, 1, 2) && Reach(v, next);
+    case OP_DROPH:
+        return PopDepth(v, 0, 1) && Reach(v, next);
+    case OP_RETURN:
+    case OP_RETURNH:
+    case OP_RETURNV:
+        return Return(v, p);
+    case OP_CALL:
+    case OP_TCALL:
+        return Fail(v, "call to an unknown function");
+    case OP_CALLI:
+        return Call(v, FindIntrinsic(v->heap, VMCODEBYTE(p + 1)), 0) && Reach(v, next);
+    default:
+        return Fail(v, "undefined opcode");
+    }
+}
+
+/* Reach - pass the current depths on to an instruction */
+static int Reach(Verifier *v, int target)
+{
+    int16_t *depths;
+    if (target == v->len)
+        return Fail(v, "falls off the end of the code");
+    if (target < 0 || target > v->len || !(v->flags[target] & V_START))
+        return Fail(v, "bad branch target");
+    depths = &v->depths[2 * target];
+    if (depths[0] == UNREACHED) {
+        depths[0] = v->depth;
+        depths[1] = v->handleDepth;
+        if (target <= v->offset)
+            v->changed = VMTRUE;
+    }
+    else if (depths[0] != v->depth || depths[1] != v->handleDepth)
+        return Fail(v, "stack depths don't match");
+    return VMTRUE;
+}
+
+/* Branch - pass the current depths on to the target of a branch instruction */
+static int Branch(Verifier *v, uint8_t *p)
+{
+    p += InstructionSize(VMCODEBYTE(p));
+    return Reach(v, (p - v->base) + GetWord(p - sizeof(VMVALUE)));
+}
+
+/* PopDepth - pop values and handles */
+static int PopDepth(Verifier *v, int values, int handles)
+{
+    if ((v->depth -= values) < 0)
+        return Fail(v, "value stack underflow");
+    if ((v->handleDepth -= handles) < 0)
+        return Fail(v, "handle stack underflow");
+    return VMTRUE;
+}
+
+/* PushDepth - push values and handles */
+static int PushDepth(Verifier *v, int values, int handles)
+{
+    if ((v->depth += values) > v->maxDepth)
+        return Fail(v, "value stack deeper than reserved");
+    if ((v->handleDepth += handles) > v->maxHandleDepth)
+        return Fail(v, "handle stack deeper than reserved");
+    return VMTRUE;
+}
+
+/* Call - replace the arguments and any function handle with the return value */
+static int Call(Verifier *v, Type *type, int handles)
+{
+    int args, handleArgs;
+    if (!type)
+        return Fail(v, "call to an unknown function");
+    CountArguments(type, &args, &handleArgs);
+    if (!PopDepth(v, args, handleArgs + handles))
+        return VMFALSE;
+    switch (ReturnOpcode(type)) {
+    case OP_RETURN:
+        return PushDepth(v, 1, 0);
+    case OP_RETURNH:
+        return PushDepth(v, 0, 1);
+    }
+    return VMTRUE;
+}
+
+/* TailCall - verify a call that replaces the current function
+ *
+ * The called function returns in place of this one so it has to return the
+ * same kind of value and its arguments have to be all there is on the stacks.
+ */
+static int TailCall(Verifier *v, Type *type)
+{
+    if (!Call(v, type, 1))
+        return VMFALSE;
+    if (ReturnOpcode(type) != v->returnOp)
+        return Fail(v, "wrong kind of return");
+    if (v->depth != (v->returnOp == OP_RETURN) || v->handleDepth != (v->returnOp == OP_RETURNH))
+        return Fail(v, "more than the arguments on the stack for a tail call");
+    return VMTRUE;
+}
+
+/* Return - verify a return instruction */
+static int Return(Verifier *v, uint8_t *p)
+{
+    int op = VMCODEBYTE(p);
+    if (op != v->returnOp)
+        return Fail(v, "wrong kind of return");
+    switch (op) {
+    case OP_RETURN:
+        return PopDepth(v, 1, 0);
+    case OP_RETURNH:
+        return PopDepth(v, 0, 1);
+    }
+    return VMTRUE;
+}
+
+/* CheckLocal - check that a local operand is an argument or a local */
+static int CheckLocal(Verifier *v, int offset)
+{
+    if (offset >= 0 ? offset < v->args : offset <= -F_SIZE - 1 && offset >= -F_SIZE - v->locals)
+        return VMTRUE;
+    return Fail(v, "bad local");
+}
+
+/* CheckSlot - check that a FOR loop slot and the one below it are locals */
+static int CheckSlot(Verifier *v, int offset)
+{
+    return CheckLocal(v, offset) && CheckLocal(v, offset - 1);
+}
+
+/* CheckHandleLocal - check that a handle local operand is an argument or a local */
+static int CheckHandleLocal(Verifier *v, int offset)
+{
+    if (offset <= 0 ? offset > -v->handleArgs : offset > HF_SIZE && offset <= HF_SIZE + v->handleLocals)
+        return VMTRUE;
+    return Fail(v, "bad handle local");
+}
+
+/* CheckGlobal - check that a global operand is a symbol of the right kind */
+static int CheckGlobal(Verifier *v, uint8_t *p, int handle)
+{
+    VMHANDLE symbol = ValueToHandle(GetWord(p));
+    if (!IsObject(v->heap, symbol) || GetHeapObjType(symbol) != ObjTypeSymbol)
+        return Fail(v, "bad global");
+    if (!IsHandleType(GetSymbolPtr(symbol)->type) != !handle)
+        return Fail(v, "wrong type of global");
+    return VMTRUE;
+}
+
+/* Fail - record a problem with the current instruction */
+static int Fail(Verifier *v, char *error)
+{
+    v->error = error;
+    return VMFALSE;
+}
+
+/* FindFunction - find the type of a function from the constant holding it */
+static Type *FindFunction(ObjHeap *heap, VMHANDLE fcn)
+{
+    VMHANDLE symbol;
+    Symbol *sym;
+    for (symbol = heap->globals.head; symbol != NULL; symbol = sym->next) {
+        sym = GetSymbolPtr(symbol);
+        if (sym->storageClass == SC_CONSTANT
+        &&  GetTypePtr(sym->type)->id == TYPE_FUNCTION
+        &&  sym->v.hValue == fcn)
+            return GetTypePtr(sym->type);
+    }
+    return NULL;
+}
+
+/* FindIntrinsic - find the type of the intrinsic function at an index in the intrinsic table */
+static Type *FindIntrinsic(ObjHeap *heap, int index)
+{
+    VMHANDLE symbol;
+    Symbol *sym;
+    if (index >= heap->nIntrinsics)
+        return NULL;
+    for (symbol = heap->globals.head; symbol != NULL; symbol = sym->next) {
+        sym = GetSymbolPtr(symbol);
+        if (sym->storageClass == SC_CONSTANT
+        &&  GetTypePtr(sym->type)->id == TYPE_FUNCTION
+        &&  IntrinsicIndex(heap, sym->v.hValue) == index)
+            return GetTypePtr(sym->type);
+    }
+    return NULL;
+}
+
+/* CountArguments - count the value and handle arguments of a function */
+static void CountArguments(Type *type, int *pArgs, int *pHandleArgs)
+{
+    VMHANDLE arg;
+    *pArgs = *pHandleArgs = 0;
+    for (arg = type->u.functionInfo.arguments.head; arg != NULL; arg = GetLocalPtr(arg)->next) {
+        if (IsHandleType(GetLocalPtr(arg)->type))
+            ++*pHandleArgs;
+        else
+            ++*pArgs;
+    }
+}
+
+/* ReturnOpcode - get the opcode a function returns with */
+static int ReturnOpcode(Type *type)
+{
+    VMHANDLE returnType = type->u.functionInfo.returnType;
+    if (!returnType)
+        return OP_RETURNV;
+    return IsHandleType(returnType) ? OP_RETURNH : OP_RETURN;
+}
+
+/* IsObject - check that a handle refers to an object in the heap */
+static int IsObject(ObjHeap *heap, VMHANDLE h)
+{
+    return h >= heap->handles && h < heap->endHandles
+        && ((uint8_t *)h - (uint8_t *)heap->handles) % sizeof(*h) == 0
+        && (uint8_t *)*h >= heap->data && (uint8_t *)*h < heap->free
+        && GetHeapObjHdr(h)->handle == h;
+}
+
+/* GetWord - get a word operand from the bytecode */
+static VMVALUE GetWord(uint8_t *p)
+{
+    VMVALUE value;
+    get_VMVALUE(value, VMCODEBYTE(p++));
+    return value;
+}
+
+#endif